@@ -3,9 +3,37 @@
     Raylib letterbox example: https://www.raylib.com/examples/core/loader.html?name=core_window_letterbox
     RedBlob Games hex grid guide: (https://www.redblobgames.com/grids/hexagons/)
 */
+#define _POSIX_C_SOURCE 199309L     // Required for: clock_gettime() under -std=c99 (before any system header)
 #include "raylib.h"
 #include "raymath.h"        // Required for: Vector2Clamp()
 #include "utils_hexmap.c"
+#include "utils_picking.c"
+#include "utils_selection.c"
+#include "utils_input.c"
+#include "utils_replay.c"
+#include "utils_entitypick.c"
+#include "utils_floodfill.c"
+#include "utils_undo.c"
+#include "utils_editor.c"
+#include "utils_viewport.c"
+#include "utils_workers.c"
+#include "utils_pathfinding.c"
+#include "utils_hpa.c"
+#include "utils_flowfield.c"
+#include "utils_pathcache.c"
+#include "utils_pathbatch.c"
+#include "utils_movement.c"
+#include "utils_components.c"
+#include "utils_influence.c"
+#include "utils_cooppath.c"
+#include "utils_fov.c"
+#include "utils_fog.c"
+#include "utils_handles.c"
+#include "utils_ecs.c"
+#include "utils_occupancy.c"
+#include <stdio.h>          // Required for: printf() (replay summary)
+#include <string.h>         // Required for: strcmp()
+#include <time.h>           // Required for: clock_gettime() (headless replay timing), time() (random seed)
 
 #define MAX(a, b) ((a)>(b)? (a) : (b))
 #define MIN(a, b) ((a)<(b)? (a) : (b))
@@ -18,11 +46,65 @@
 #define TILESET_COLUMNS 7
 #define TILESET_ROWS 14
 #define SCALE_FACTOR 2 // Scale image to 1/5th size
+#define PICK_ALPHA_THRESHOLD 128 // Sprite pixels at least this opaque count as the tile for picking
+
+// Camera zoom limits (mouse wheel)
+#define CAMERA_MIN_ZOOM 0.25f
+#define CAMERA_MAX_ZOOM 4.0f
+
+// Overview inset size and its zoom limits, relative to the zoom that fits the whole map
+#define OVERVIEW_WIDTH 240
+#define OVERVIEW_HEIGHT 160
+#define OVERVIEW_MARGIN 10
+#define OVERVIEW_MIN_ZOOM 0.5f
+#define OVERVIEW_MAX_ZOOM 8.0f
+
+// Box/lasso selection
+#define DRAG_THRESHOLD 4.0f         // Mouse travel (virtual pixels) before a click becomes a drag
+#define LASSO_POINT_SPACING 3.0f    // Minimum distance between recorded lasso points
+#define MAX_LASSO_POINTS 1024
+#define MAX_SELECTED_ENTITIES 1024
+#define ENTITY_PICK_CELL_SIZE 64    // Screen bucket size of the entity pick grid
+
+// Terrain undo budget in tile changes (8 bytes each)
+#define UNDO_MAX_DELTAS (1 << 20)
+
+// Movement range shown for the selected tile (stand-in for a unit until units exist)
+#define UNIT_MOVE_POINTS 40
+#define INFLUENCE_RADIUS 4          // Reach of the influence overlay sources
+#define HYPERLANE_COST 10           // Cost of crossing a hyperlane placed with W
+#define COOP_WINDOW 16              // Time steps planned ahead by cooperative moves
+#define SIGHT_RADIUS 8              // Field of view radius shown with O, and of fog of war viewers
+#define FOG_EXPLORED (Color){ 150, 150, 150, 255 }  // Tint of tiles seen before but not now
+#define FOG_UNEXPLORED (Color){ 40, 40, 40, 255 }   // Tint of tiles never seen
+
+// Entity demo: fleets and planets simulated a turn at a time with N
+#define DEMO_FLEETS 100000
+#define DEMO_PLANETS 1000
+#define DEMO_PLAYERS 4
+#define FLEET_UPKEEP 1
+#define FLEET_HEALTH 20
+#define PLANET_INCOME 100
+#define NEARBY_RADIUS 2             // Reach of the hovered tile's "entities nearby" count
+
+// Input is sampled again after this many tiles have been submitted for drawing
+#define INPUT_PUMP_INTERVAL 4096
 
 // Scaled tile dimensions
 #define SCALED_TILE_WIDTH (TILE_WIDTH / SCALE_FACTOR)
 #define SCALED_TILE_HEIGHT (TILE_HEIGHT / SCALE_FACTOR)
 
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+// Entity components of the turn demo
+typedef struct UnitPosition { int tile; } UnitPosition;
+typedef struct UnitOwner { int player; } UnitOwner;
+typedef struct UnitUpkeep { int credits; } UnitUpkeep;
+typedef struct UnitMovement { int heading; } UnitMovement;     // Hex direction the fleet flies
+typedef struct UnitHealth { int health; } UnitHealth;
+typedef struct PlanetIncome { int credits; } PlanetIncome;
+
 //------------------------------------------------------------------------------------
 // Global Variables
 //------------------------------------------------------------------------------------
@@ -32,6 +114,92 @@ static int gameScreenHeight = 800;
 static Layout hexLayout;
 static Map map;
 static Texture2D tilesetTexture;
+static TerrainBake terrainBake;
+static Viewport mainView;           // Full-screen game view
+static Viewport overview;           // Inset showing the whole map
+static float overviewFitZoom;       // Overview zoom that fits the whole map
+static bool overviewDragging = false;
+static PickCache pickCache;
+static PickMask pickMask;
+static Tile* hoveredTile = NULL;
+
+static InputQueue inputQueue;
+static Vector2 mousePosition = { 0 };
+static bool leftDown = false;
+static bool panActive = false;
+
+static TileSelection selection;
+static Vector2 dragStart;
+static bool dragActive = false;
+static bool lassoMode = false;
+static Vector2 lassoPoints[MAX_LASSO_POINTS];
+static int lassoPointCount = 0;
+static double lastSelectionMs = 0.0;
+
+static EntityPickGrid entityPickGrid;
+static Entity selectedEntities[MAX_SELECTED_ENTITIES];
+static int selectedEntityCount = 0;
+
+static FloodFill regionFill;
+static UndoHistory undoHistory;
+
+// Path preview from the selected tile to the hovered tile
+static PathScratch pathScratch;
+static PathProfile pathProfile;
+static int* pathTiles = NULL;
+static int pathLength = 0;
+static int pathCost = 0;
+static double pathMs = 0.0;
+static int pathStart = -1;
+static int pathGoal = -1;
+static unsigned int pathRevision = 0;
+static PathCache pathCache;
+static WalkableComponents walkComponents;
+static HpaGraph hpaGraph;
+static bool pathHierarchical = false;   // Preview with HPA* instead of A*
+static FlowFieldCache flowFields;
+static int flowGoal = -1;               // Goal tile of the displayed flow field, -1 for none
+static WorkerPool workerPool;
+static PathBatch pathBatch;
+static PathQuery* batchQueries = NULL;
+static int batchQueryCount = 0;
+static int batchReached = 0;
+static double batchMs = 0.0;
+static MovementRange moveRange;
+static bool showMoveRange = false;
+static InfluenceMap influenceMap;
+static bool showInfluence = false;
+static double influenceMs = 0.0;
+static CoopPlanner coopPlanner;
+static int* coopPaths = NULL;           // Per unit: COOP_WINDOW + 1 tiles, one per time step
+static int* coopLengths = NULL;
+static int coopUnitCount = 0;
+static int coopReached = 0;
+static double coopMs = 0.0;
+static uint32_t* sightVisible = NULL;   // Field of view from the hovered tile, one bit per tile
+static int* sightTiles = NULL;
+static int sightCount = 0;
+static bool showSight = false;
+static FogOfWar fogOfWar;
+static Color* fogTint = NULL;           // Terrain bake tint per tile: visible, explored or unexplored
+static int fogScout = -1;               // Viewer following the hovered tile
+static int fogChangeCount = 0;
+static double fogMs = 0.0;
+static bool showFog = false;
+static EcsWorld world;
+static int positionComponent, ownerComponent, upkeepComponent, movementComponent, healthComponent, incomeComponent;
+static OccupancyIndex occupancy;        // Entities on each tile
+static Vector2 entityPickHalfSize;      // Half size of the pick rect of an entity, centered on its tile
+static int treasury[DEMO_PLAYERS];
+static int turnNumber = 0;
+static int turnLosses = 0;
+static double turnMs = 0.0;
+static MapEditor editor;
+static int lastStrokeTiles = 0;
+
+static unsigned int frameCounter = 0;
+static InputRecording recording = { 0 };
+static bool recordingEnabled = false;
 
 //------------------------------------------------------------------------------------
 // Module Functions
@@ -73,7 +241,8 @@ static Rectangle getTileSourceRect(TileType type)
     return (Rectangle){ x, y, (float)SCALED_TILE_WIDTH, (float)SCALED_TILE_HEIGHT };
 }
 
-static void initGame(void)
+// Needs an OpenGL context, so it is skipped by the headless replay mode
+static void loadTileset(void)
 {
     // Load tileset texture from terrain.png (7 columns × 14 rows, 120×140px tiles, 1px padding)
     Image tilesetImage = LoadImage("resources/terrain.png");
@@ -87,8 +256,39 @@ static void initGame(void)
         ImageResize(&tilesetImage, tilesetImage.width / SCALE_FACTOR, tilesetImage.height / SCALE_FACTOR);
         tilesetTexture = LoadTextureFromImage(tilesetImage);
         UnloadImage(tilesetImage);
+
+        // Every viewport draws the terrain from this bake instead of one sprite per tile
+        Rectangle sources[TILE_TYPE_COUNT];
+        for (int t = 0; t < TILE_TYPE_COUNT; t++) sources[t] = getTileSourceRect((TileType)t);
+        InitTerrainBake(&terrainBake, &map, hexLayout, tilesetTexture, sources,
+                        (Vector2){ (float)SCALED_TILE_WIDTH, (float)SCALED_TILE_HEIGHT }, RAYWHITE);
     }
-    
+}
+
+// Builds the pixel-accurate picking lookup from the sprite footprint (CPU only, works headless)
+static void loadPickMask(void)
+{
+    Image tilesetImage = LoadImage("resources/terrain.png");
+    if (!IsImageValid(tilesetImage))
+    {
+        TraceLog(LOG_WARNING, "Pick mask unavailable, using analytic hex picking");
+        return;
+    }
+
+    ImageResize(&tilesetImage, tilesetImage.width / SCALE_FACTOR, tilesetImage.height / SCALE_FACTOR);
+    Image sprite = ImageFromImage(tilesetImage, getTileSourceRect(TILE_GRASS));
+    pickMask = BuildPickMask(hexLayout, sprite, (Vector2){ (float)SCALED_TILE_WIDTH, (float)SCALED_TILE_HEIGHT }, PICK_ALPHA_THRESHOLD);
+    UnloadImage(sprite);
+    UnloadImage(tilesetImage);
+
+    if (pickMask.offsets != NULL) pickCache.mask = &pickMask;
+}
+
+// The seed makes the demo's random choices repeatable: live sessions record it, replays reuse it
+static void initGame(unsigned int seed)
+{
+    SetRandomSeed(seed);
+
     // Initialize hex layout with pointy-top orientation
     // For pointy-top hexagons, we need to calculate proper spacing:
     // - Horizontal spacing between centers = √3 * size.x (should equal tile width)
@@ -103,6 +303,39 @@ static void initGame(void)
     
     // Create map using the utility function
     map = CreateMap(origin, size, MAP_RADIUS);
+    selection = CreateTileSelection(&map);
+    entityPickGrid = CreateEntityPickGrid(gameScreenWidth, gameScreenHeight, ENTITY_PICK_CELL_SIZE);
+    regionFill = CreateFloodFill(&map);
+    undoHistory = CreateUndoHistory(&map, UNDO_MAX_DELTAS);
+    editor = CreateMapEditor(&map);
+    editor.history = &undoHistory;
+    pathScratch = CreatePathScratch(&map);
+    pathProfile = DefaultPathProfile();
+    pathTiles = (int*)malloc(map.tileCount*sizeof(int));
+    InitPathCache(&pathCache, &map);
+    InitWalkableComponents(&walkComponents, &map);
+    InitHpaGraph(&hpaGraph, &map, pathProfile);
+    InitFlowFieldCache(&flowFields, &map, pathProfile);
+    InitWorkerPool(&workerPool, GetProcessorCount());
+    pathBatch = CreatePathBatch(&map);
+    batchQueries = (PathQuery*)malloc(map.tileCount*sizeof(PathQuery));
+    InitMovementRange(&moveRange, &map);
+    InitInfluenceMap(&influenceMap, &map, 1, (InfluenceFalloff){ INFLUENCE_FALLOFF_LINEAR, INFLUENCE_RADIUS, 0.0f });
+    InitCoopPlanner(&coopPlanner, &map, pathProfile, COOP_WINDOW);
+    sightVisible = (uint32_t*)calloc((map.tileCount + 31)/32, sizeof(uint32_t));
+    sightTiles = (int*)malloc(GetFieldOfViewCapacity(SIGHT_RADIUS)*sizeof(int));
+    InitFogOfWar(&fogOfWar, &map, 1, SIGHT_RADIUS);
+    fogTint = (Color*)malloc(map.tileCount*sizeof(Color));
+    InitEcsWorld(&world);
+    positionComponent = RegisterEcsComponent(&world, sizeof(UnitPosition));
+    ownerComponent = RegisterEcsComponent(&world, sizeof(UnitOwner));
+    upkeepComponent = RegisterEcsComponent(&world, sizeof(UnitUpkeep));
+    movementComponent = RegisterEcsComponent(&world, sizeof(UnitMovement));
+    healthComponent = RegisterEcsComponent(&world, sizeof(UnitHealth));
+    incomeComponent = RegisterEcsComponent(&world, sizeof(PlanetIncome));
+    InitOccupancyIndex(&occupancy, &map);
+    Rectangle innerBounds = HexInnerBounds(hexLayout, MakeHex(0, 0, 0));
+    entityPickHalfSize = (Vector2){ innerBounds.width/2.0f, innerBounds.height/2.0f };
     
     // Set center tile to a different type for testing
     Hex centerHex = MakeHex(0, 0, 0);
@@ -112,31 +345,725 @@ static void initGame(void)
     SetTileType(&map, MakeHex(1, -1, 0), TILE_ROCKS);
     SetTileType(&map, MakeHex(-1, 1, 0), TILE_SAND);
     SetTileType(&map, MakeHex(0, 1, -1), TILE_FOREST);
+
+    // Identity camera: world space equals virtual screen space until the user pans/zooms
+    mainView.bounds = (Rectangle){ 0, 0, (float)gameScreenWidth, (float)gameScreenHeight };
+    mainView.camera = (Camera2D){ 0 };
+    mainView.camera.zoom = 1.0f;
+    mainView.visible = true;
+
+    // Overview inset in the bottom right corner, zoomed to fit the whole map
+    overview.bounds = (Rectangle){ (float)(gameScreenWidth - OVERVIEW_WIDTH - OVERVIEW_MARGIN), (float)(gameScreenHeight - OVERVIEW_HEIGHT - OVERVIEW_MARGIN - 30),
+                                   (float)OVERVIEW_WIDTH, (float)OVERVIEW_HEIGHT };
+    Rectangle mapBounds = GetMapWorldBounds(&map, hexLayout, (Vector2){ (float)SCALED_TILE_WIDTH, (float)SCALED_TILE_HEIGHT });
+    overview.camera = (Camera2D){ 0 };
+    overview.camera.target = (Vector2){ mapBounds.x + mapBounds.width/2.0f, mapBounds.y + mapBounds.height/2.0f };
+    overview.camera.offset = (Vector2){ OVERVIEW_WIDTH/2.0f, OVERVIEW_HEIGHT/2.0f };
+    overviewFitZoom = 0.95f*MIN(OVERVIEW_WIDTH/mapBounds.width, OVERVIEW_HEIGHT/mapBounds.height);
+    overview.camera.zoom = overviewFitZoom;
+    overview.visible = true;
+    ResetPickCache(&pickCache);
+    loadPickMask();
+    InitInputQueue(&inputQueue, getVirtualMouse);
+}
+
+// Puts an entity on a tile in the occupancy index and registers its tile rect for picking
+// (pick ids are handle slots, see GetEntityInSlot())
+static void placeEntity(Entity entity, int tile)
+{
+    PlaceOccupant(&occupancy, entity, tile);
+    Point center = HexToPixel(hexLayout, map.tiles[tile].position);
+    Rectangle bounds = { center.x - entityPickHalfSize.x, center.y - entityPickHalfSize.y, 2.0f*entityPickHalfSize.x, 2.0f*entityPickHalfSize.y };
+    UpdatePickEntity(&entityPickGrid, (unsigned int)GetHandleIndex(entity), bounds);
+}
+
+static void removeEntity(Entity entity)
+{
+    RemoveOccupant(&occupancy, entity);
+    RemovePickEntity(&entityPickGrid, (unsigned int)GetHandleIndex(entity));
+}
+
+// Random walkable tile: the first one from a random start, -1 if no tile is walkable (the
+// editor can paint the whole map water or rocks)
+static int randomWalkableTile(void)
+{
+    int start = GetRandomValue(0, map.tileCount - 1);
+    for (int k = 0; k < map.tileCount; k++)
+    {
+        int tile = (start + k)%map.tileCount;
+        if (map.tiles[tile].isWalkable) return tile;
+    }
+    return -1;
+}
+
+// Fleet at a random walkable tile (none without one); created while systems run, it is
+// added once they finish
+static void spawnFleet(int player)
+{
+    int tile = randomWalkableTile();
+    if (tile < 0) return;
+
+    Entity fleet = CreateEntity(&world);
+    AddComponent(&world, fleet, positionComponent, &(UnitPosition){ tile });
+    AddComponent(&world, fleet, ownerComponent, &(UnitOwner){ player });
+    AddComponent(&world, fleet, upkeepComponent, &(UnitUpkeep){ FLEET_UPKEEP });
+    AddComponent(&world, fleet, movementComponent, &(UnitMovement){ GetRandomValue(0, 5) });
+    AddComponent(&world, fleet, healthComponent, &(UnitHealth){ GetRandomValue(1, FLEET_HEALTH) });
+    placeEntity(fleet, tile);
+}
+
+static void spawnDemoEntities(void)
+{
+    for (int k = 0; k < DEMO_PLANETS; k++)
+    {
+        int tile = randomWalkableTile();
+        if (tile < 0) break;
+
+        Entity planet = CreateEntity(&world);
+        AddComponent(&world, planet, positionComponent, &(UnitPosition){ tile });
+        AddComponent(&world, planet, ownerComponent, &(UnitOwner){ k%DEMO_PLAYERS });
+        AddComponent(&world, planet, incomeComponent, &(PlanetIncome){ PLANET_INCOME });
+        placeEntity(planet, tile);
+    }
+    for (int k = 0; k < DEMO_FLEETS; k++) spawnFleet(k%DEMO_PLAYERS);
+}
+
+// Upkeep: planets pay their owner, fleets cost theirs
+static void incomeSystem(EcsWorld* ecs, const EcsView* view, void* userData)
+{
+    (void)ecs; (void)userData;
+    const UnitOwner* owner = (const UnitOwner*)GetEcsColumn(view, ownerComponent);
+    const PlanetIncome* income = (const PlanetIncome*)GetEcsColumn(view, incomeComponent);
+    for (int i = 0; i < view->count; i++) treasury[owner[i].player] += income[i].credits;
+}
+
+static void upkeepSystem(EcsWorld* ecs, const EcsView* view, void* userData)
+{
+    (void)ecs; (void)userData;
+    const UnitOwner* owner = (const UnitOwner*)GetEcsColumn(view, ownerComponent);
+    const UnitUpkeep* upkeep = (const UnitUpkeep*)GetEcsColumn(view, upkeepComponent);
+    for (int i = 0; i < view->count; i++) treasury[owner[i].player] -= upkeep[i].credits;
+}
+
+// Movement: fleets fly one tile along their heading and turn when the way is blocked
+static void movementSystem(EcsWorld* ecs, const EcsView* view, void* userData)
+{
+    (void)ecs; (void)userData;
+    UnitPosition* position = (UnitPosition*)GetEcsColumn(view, positionComponent);
+    UnitMovement* movement = (UnitMovement*)GetEcsColumn(view, movementComponent);
+    for (int i = 0; i < view->count; i++)
+    {
+        int next = GetTileIndex(&map, HexNeighbor(map.tiles[position[i].tile].position, movement[i].heading));
+        if (next >= 0 && map.tiles[next].isWalkable)
+        {
+            position[i].tile = next;
+            placeEntity(view->entities[i], next);
+        }
+        else movement[i].heading = (movement[i].heading + 1)%6;
+    }
+}
+
+// Combat: fleets wear down; destroyed fleets are replaced for their owner (both deferred
+// until the system is done)
+static void attritionSystem(EcsWorld* ecs, const EcsView* view, void* userData)
+{
+    (void)userData;
+    UnitHealth* health = (UnitHealth*)GetEcsColumn(view, healthComponent);
+    const UnitOwner* owner = (const UnitOwner*)GetEcsColumn(view, ownerComponent);
+    for (int i = 0; i < view->count; i++)
+    {
+        if (--health[i].health > 0) continue;
+        removeEntity(view->entities[i]);
+        DestroyEntity(ecs, view->entities[i]);
+        spawnFleet(owner[i].player);
+        turnLosses++;
+    }
+}
+
+static void runTurn(void)
+{
+    if (GetEntityCount(&world) == 0) spawnDemoEntities();
+
+    double startTime = GetTime();
+    EcsMask owned = ECS_MASK(ownerComponent);
+    turnLosses = 0;
+    InvalidatePickGrid(&entityPickGrid);    // Most fleets move: re-file them all once, on the next click
+    // Input keeps being captured between the systems of a long turn
+    RunEcsSystem(&world, owned | ECS_MASK(incomeComponent), 0, incomeSystem, NULL);
+    PumpInputEvents(&inputQueue);
+    RunEcsSystem(&world, owned | ECS_MASK(upkeepComponent), 0, upkeepSystem, NULL);
+    PumpInputEvents(&inputQueue);
+    RunEcsSystem(&world, ECS_MASK(positionComponent) | ECS_MASK(movementComponent), 0, movementSystem, NULL);
+    PumpInputEvents(&inputQueue);
+    RunEcsSystem(&world, owned | ECS_MASK(healthComponent), 0, attritionSystem, NULL);
+    PumpInputEvents(&inputQueue);
+    turnMs = (GetTime() - startTime)*1000.0;
+    turnNumber++;
+
+    // Destroyed fleets leave the selection
+    int kept = 0;
+    for (int e = 0; e < selectedEntityCount; e++)
+    {
+        if (IsEntityAlive(&world, selectedEntities[e])) selectedEntities[kept++] = selectedEntities[e];
+    }
+    selectedEntityCount = kept;
+}
+
+// Overview inset: wheel zooms the inset, left click/drag centers the main view on that point
+static void handleOverviewEvent(const InputEvent* event)
+{
+    Vector2 position = event->position;
+    Vector2 local = { position.x - overview.bounds.x, position.y - overview.bounds.y };
+
+    if (event->type == INPUT_MOUSE_WHEEL)
+    {
+        overview.camera.target = GetScreenToWorld2D(local, overview.camera);
+        overview.camera.offset = local;
+        float scaleFactor = 1.0f + 0.25f*fabsf(event->wheel);
+        if (event->wheel < 0.0f) scaleFactor = 1.0f/scaleFactor;
+        overview.camera.zoom = Clamp(overview.camera.zoom*scaleFactor, OVERVIEW_MIN_ZOOM*overviewFitZoom, OVERVIEW_MAX_ZOOM*overviewFitZoom);
+    }
+    else if (event->type == INPUT_MOUSE_PRESSED && event->code == MOUSE_BUTTON_LEFT)
+    {
+        overviewDragging = true;
+    }
+    else if (event->type == INPUT_MOUSE_RELEASED && event->code == MOUSE_BUTTON_LEFT)
+    {
+        overviewDragging = false;
+    }
+
+    if (overviewDragging)
+    {
+        mainView.camera.target = GetViewportToWorld(&overview, position);
+        mainView.camera.offset = (Vector2){ mainView.bounds.width/2.0f, mainView.bounds.height/2.0f };
+    }
+}
+
+// Apply one queued input event (positions are virtual screen coordinates at the time of the event)
+static void handleInputEvent(const InputEvent* event)
+{
+    Vector2 position = event->position;
+
+    // Mouse events over the overview go to the overview, unless a main view action is in progress
+    if (event->type != INPUT_KEY_PRESSED && overview.visible &&
+        (overviewDragging || (CheckCollisionPointRec(position, overview.bounds) && !leftDown && !panActive && !editor.stroking)))
+    {
+        handleOverviewEvent(event);
+        mousePosition = position;
+        return;
+    }
+
+    switch (event->type)
+    {
+        case INPUT_MOUSE_WHEEL:
+        {
+            // Zoom around the mouse cursor
+            mainView.camera.target = GetScreenToWorld2D(position, mainView.camera);
+            mainView.camera.offset = position;
+            float scaleFactor = 1.0f + 0.25f*fabsf(event->wheel);
+            if (event->wheel < 0.0f) scaleFactor = 1.0f/scaleFactor;
+            mainView.camera.zoom = Clamp(mainView.camera.zoom*scaleFactor, CAMERA_MIN_ZOOM, CAMERA_MAX_ZOOM);
+        } break;
+
+        case INPUT_MOUSE_MOVED:
+        {
+            // Pan with the middle mouse button
+            if (panActive)
+            {
+                Vector2 delta = Vector2Scale(Vector2Subtract(position, mousePosition), -1.0f/mainView.camera.zoom);
+                mainView.camera.target = Vector2Add(mainView.camera.target, delta);
+            }
+
+            if (editor.stroking)
+            {
+                PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                ContinueEditorStroke(&editor, &map, pickCache.hex);
+            }
+            else if (leftDown)
+            {
+                if (!dragActive && Vector2Distance(dragStart, position) > DRAG_THRESHOLD) dragActive = true;
+
+                if (dragActive && lassoMode && lassoPointCount < MAX_LASSO_POINTS &&
+                    Vector2Distance(lassoPoints[lassoPointCount - 1], position) >= LASSO_POINT_SPACING)
+                {
+                    lassoPoints[lassoPointCount++] = position;
+                }
+            }
+        } break;
+
+        case INPUT_MOUSE_PRESSED:
+        {
+            if (event->code == MOUSE_BUTTON_LEFT && editor.enabled)
+            {
+                // Editor: paint with the current tool, applied to the map when the button is released
+                PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                BeginEditorStroke(&editor, &map, pickCache.hex);
+            }
+            else if (event->code == MOUSE_BUTTON_LEFT)
+            {
+                // Left button: click selects one tile, drag selects a box (Ctrl+drag: lasso), Shift adds
+                leftDown = true;
+                dragStart = position;
+                dragActive = false;
+                lassoMode = (event->modifiers & INPUT_MOD_CONTROL) != 0;
+                lassoPoints[0] = position;
+                lassoPointCount = 1;
+            }
+            else if (event->code == MOUSE_BUTTON_RIGHT)
+            {
+                // Change tile type (for testing)
+                Tile* tile = PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                if (tile != NULL) {
+                    // Cycle through tile types
+                    int index = GetTileIndex(&map, tile->position);
+                    TileType type = (tile->type + 1) % TILE_TYPE_COUNT;
+                    RecordTileTypes(&undoHistory, &map, &index, 1, type, false);
+                    SetTileTypes(&map, &index, 1, type);
+                }
+            }
+            else if (event->code == MOUSE_BUTTON_MIDDLE)
+            {
+                panActive = true;
+            }
+        } break;
+
+        case INPUT_MOUSE_RELEASED:
+        {
+            if (event->code == MOUSE_BUTTON_LEFT && editor.stroking)
+            {
+                lastStrokeTiles = EndEditorStroke(&editor, &map, event->time);
+            }
+            else if (event->code == MOUSE_BUTTON_LEFT && leftDown)
+            {
+                bool additive = (event->modifiers & INPUT_MOD_SHIFT) != 0;
+
+                // Entities are hit before tiles: a click or box that touches entities selects them
+                SetPickGridCamera(&entityPickGrid, mainView.camera);
+                unsigned int hits[MAX_SELECTED_ENTITIES];
+                int entityHits = 0;
+                if (dragActive && !lassoMode)
+                {
+                    Rectangle box = { MIN(dragStart.x, position.x), MIN(dragStart.y, position.y),
+                                      fabsf(position.x - dragStart.x), fabsf(position.y - dragStart.y) };
+                    entityHits = QueryEntitiesInRect(&entityPickGrid, box, hits, MAX_SELECTED_ENTITIES);
+                }
+                else if (!dragActive)
+                {
+                    hits[0] = PickEntityAt(&entityPickGrid, position);
+                    if (hits[0] != PICK_NO_ENTITY) entityHits = 1;
+                }
+
+                if (!additive) selectedEntityCount = 0;
+                for (int h = 0; h < entityHits; h++)
+                {
+                    Entity entity = GetEntityInSlot(&world, (int)hits[h]);
+                    bool known = (entity == ECS_NO_ENTITY);
+                    for (int e = 0; e < selectedEntityCount && !known; e++) known = (selectedEntities[e] == entity);
+                    if (!known && selectedEntityCount < MAX_SELECTED_ENTITIES) selectedEntities[selectedEntityCount++] = entity;
+                }
+
+                if (entityHits > 0)
+                {
+                    if (!additive) ClearTileSelection(&selection, &map);
+                }
+                else if (dragActive)
+                {
+                    // Selection polygon in world space (the camera may be panned/zoomed)
+                    Vector2 polygon[MAX_LASSO_POINTS];
+                    int pointCount = 0;
+                    if (lassoMode)
+                    {
+                        for (int i = 0; i < lassoPointCount; i++) polygon[pointCount++] = GetScreenToWorld2D(lassoPoints[i], mainView.camera);
+                    }
+                    else
+                    {
+                        polygon[pointCount++] = GetScreenToWorld2D(dragStart, mainView.camera);
+                        polygon[pointCount++] = GetScreenToWorld2D((Vector2){ position.x, dragStart.y }, mainView.camera);
+                        polygon[pointCount++] = GetScreenToWorld2D(position, mainView.camera);
+                        polygon[pointCount++] = GetScreenToWorld2D((Vector2){ dragStart.x, position.y }, mainView.camera);
+                    }
+
+                    double startTime = GetTime();
+                    SelectTilesInPolygon(&selection, &map, hexLayout, polygon, pointCount, additive);
+                    lastSelectionMs = (GetTime() - startTime)*1000.0;
+                }
+                else
+                {
+                    PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                    if (additive)
+                    {
+                        int index = GetTileIndex(&map, pickCache.hex);
+                        if (index >= 0) SelectTileRange(&selection, &map, index, index);
+                    }
+                    else
+                    {
+                        SelectSingleTile(&selection, &map, pickCache.hex);
+                    }
+                }
+
+                leftDown = false;
+                dragActive = false;
+            }
+            else if (event->code == MOUSE_BUTTON_MIDDLE)
+            {
+                panActive = false;
+            }
+        } break;
+
+        case INPUT_KEY_PRESSED:
+        {
+            // Toggle between pixel-accurate (sprite mask) and analytic hex picking
+            if (event->code == KEY_P && pickMask.offsets != NULL)
+            {
+                pickCache.mask = (pickCache.mask == NULL)? &pickMask : NULL;
+            }
+
+            // Region query: select the connected area of the hovered terrain (Shift: walkable area)
+            if (event->code == KEY_R && !editor.enabled)
+            {
+                PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                RegionMatch match = (event->modifiers & INPUT_MOD_SHIFT)? REGION_WALKABLE : REGION_SAME_TYPE;
+
+                double startTime = GetTime();
+                if (FloodFillRegion(&regionFill, &map, pickCache.hex, match, NULL, NULL, NULL, 0) >= 0)
+                {
+                    // Out of memory (-1) keeps the current selection instead of a partial region
+                    ClearTileSelection(&selection, &map);
+                    for (int i = NextRegionTile(&regionFill, -1); i >= 0; i = NextRegionTile(&regionFill, i))
+                    {
+                        SelectTileRange(&selection, &map, i, i);
+                    }
+                }
+                lastSelectionMs = (GetTime() - startTime)*1000.0;
+            }
+
+            // Terrain undo (Ctrl+Z) / redo (Ctrl+Y or Ctrl+Shift+Z)
+            if ((event->modifiers & INPUT_MOD_CONTROL) && !editor.stroking)
+            {
+                if (event->code == KEY_Z && !(event->modifiers & INPUT_MOD_SHIFT)) UndoMapChange(&undoHistory, &map);
+                if (event->code == KEY_Y || (event->code == KEY_Z && (event->modifiers & INPUT_MOD_SHIFT))) RedoMapChange(&undoHistory, &map);
+            }
+
+            // Path preview: A* or hierarchical (HPA*)
+            if (event->code == KEY_H)
+            {
+                pathHierarchical = !pathHierarchical;
+                pathStart = -1;     // Search again
+            }
+
+            // Flow field towards the hovered tile (again on the same tile: hide it)
+            if (event->code == KEY_G)
+            {
+                PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                int index = GetTileIndex(&map, pickCache.hex);
+                flowGoal = (index == flowGoal)? -1 : index;
+            }
+
+            // Batch paths from every selected tile to the hovered tile on the worker pool
+            if (event->code == KEY_T)
+            {
+                PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                batchQueryCount = 0;
+                for (int i = NextSelectedTile(&selection, -1); i >= 0; i = NextSelectedTile(&selection, i))
+                {
+                    batchQueries[batchQueryCount++] = (PathQuery){ map.tiles[i].position, pickCache.hex };
+                }
+
+                double startTime = GetTime();
+                batchReached = FindPathBatch(&pathBatch, &workerPool, &pathProfile, batchQueries, batchQueryCount);
+                batchMs = (GetTime() - startTime)*1000.0;
+                PumpInputEvents(&inputQueue);
+            }
+
+            // Influence overlay: the selected tiles are the sources (snapshot taken on toggle)
+            if (event->code == KEY_I)
+            {
+                showInfluence = !showInfluence;
+                if (showInfluence)
+                {
+                    ClearInfluenceSources(&influenceMap);
+                    for (int i = NextSelectedTile(&selection, -1); i >= 0; i = NextSelectedTile(&selection, i))
+                    {
+                        AddInfluenceSource(&influenceMap, 0, map.tiles[i].position, 1.0f);
+                    }
+                    double startTime = GetTime();
+                    UpdateInfluenceMap(&influenceMap, &workerPool);
+                    influenceMs = (GetTime() - startTime)*1000.0;
+                    PumpInputEvents(&inputQueue);
+                }
+            }
+
+            // Movement range of the selected tile
+            if (event->code == KEY_M) showMoveRange = !showMoveRange;
+
+            // Field of view from the hovered tile
+            if (event->code == KEY_O) showSight = !showSight;
+
+            // One turn of the entity demo (spawns the fleets and planets on the first press)
+            if (event->code == KEY_N) runTurn();
+
+            // Fog of war for player 0: every selected tile is a unit that sees, plus a scout
+            // following the hovered tile (again: lift the fog and forget what was explored)
+            if (event->code == KEY_X)
+            {
+                showFog = !showFog;
+                UnloadFogOfWar(&fogOfWar);
+                InitFogOfWar(&fogOfWar, &map, 1, SIGHT_RADIUS);
+                if (showFog)
+                {
+                    for (int i = NextSelectedTile(&selection, -1); i >= 0; i = NextSelectedTile(&selection, i))
+                    {
+                        AddFogViewer(&fogOfWar, 0, map.tiles[i].position, SIGHT_RADIUS);
+                    }
+                    PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                    fogScout = AddFogViewer(&fogOfWar, 0, pickCache.hex, SIGHT_RADIUS);
+                    for (int i = 0; i < map.tileCount; i++) fogTint[i] = IsTileVisibleTo(&fogOfWar, 0, i)? WHITE : FOG_UNEXPLORED;
+                    ClearFogChanges(&fogOfWar);
+                }
+                SetTerrainBakeTint(&terrainBake, showFog? fogTint : NULL);
+            }
+
+            // Cooperative moves: every selected tile is a unit heading for the hovered tile,
+            // planned one after another against the reservations of the previous ones (again: hide)
+            if (event->code == KEY_C)
+            {
+                if (coopUnitCount > 0) coopUnitCount = 0;
+                else if (selection.count > 0)
+                {
+                    PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                    coopPaths = (int*)realloc(coopPaths, selection.count*(COOP_WINDOW + 1)*sizeof(int));
+                    coopLengths = (int*)realloc(coopLengths, selection.count*sizeof(int));
+
+                    double startTime = GetTime();
+                    ClearCoopReservations(&coopPlanner);
+                    coopReached = 0;
+                    for (int i = NextSelectedTile(&selection, -1); i >= 0; i = NextSelectedTile(&selection, i))
+                    {
+                        int* plan = coopPaths + coopUnitCount*(COOP_WINDOW + 1);
+                        int length = PlanCoopPath(&coopPlanner, coopUnitCount, map.tiles[i].position, pickCache.hex, plan);
+                        if (length > 0 && HexEquals(map.tiles[plan[length - 1]].position, pickCache.hex)) coopReached++;
+                        coopLengths[coopUnitCount++] = length;
+                    }
+                    coopMs = (GetTime() - startTime)*1000.0;
+                }
+            }
+
+            // Two-way hyperlane between the selected tile and the hovered tile (again: remove it)
+            if (event->code == KEY_W && selection.count == 1)
+            {
+                PickTileCached(&pickCache, &map, hexLayout, mainView.camera, position);
+                Hex from = map.tiles[NextSelectedTile(&selection, -1)].position;
+                if (RemoveOverlayEdge(&map, from, pickCache.hex)) RemoveOverlayEdge(&map, pickCache.hex, from);
+                else if (AddOverlayEdge(&map, from, pickCache.hex, HYPERLANE_COST)) AddOverlayEdge(&map, pickCache.hex, from, HYPERLANE_COST);
+            }
+
+            // Toggle the overview inset
+            if (event->code == KEY_V)
+            {
+                overview.visible = !overview.visible;
+                overviewDragging = false;
+            }
+
+            // Editor mode and tools
+            if (event->code == KEY_E)
+            {
+                editor.enabled = !editor.enabled;
+                CancelEditorStroke(&editor);
+            }
+            if (editor.enabled)
+            {
+                if (event->code == KEY_B) editor.tool = EDITOR_TOOL_BRUSH;
+                if (event->code == KEY_L) editor.tool = EDITOR_TOOL_LINE;
+                if (event->code == KEY_F) editor.tool = EDITOR_TOOL_FILL;
+                if (event->code >= KEY_ONE && event->code < KEY_ONE + TILE_TYPE_COUNT) editor.paintType = (TileType)(event->code - KEY_ONE);
+                if (event->code == KEY_LEFT_BRACKET && editor.brushRadius > 0) editor.brushRadius--;
+                if (event->code == KEY_RIGHT_BRACKET && editor.brushRadius < EDITOR_MAX_BRUSH_RADIUS) editor.brushRadius++;
+            }
+        } break;
+
+        default: break;
+    }
+
+    mousePosition = position;
 }
 
 static void updateGame(void)
 {
-    // Handle mouse click to select tile
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+    // Consume everything captured since the last update, in the order it happened
+    InputEvent event;
+    while (PopInputEvent(&inputQueue, &event))
     {
-        Vector2 virtualMouse = getVirtualMouse();
-        Point mousePoint = { virtualMouse.x, virtualMouse.y };
-        Hex clickedHex = PixelToHex(hexLayout, mousePoint);
-        SetTileSelected(&map, clickedHex, true);
+        if (recordingEnabled) RecordInputEvent(&recording, frameCounter, &event);
+        handleInputEvent(&event);
     }
-    
-    // Handle right click to change tile type (for testing)
-    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))
-    {
-        Vector2 virtualMouse = getVirtualMouse();
-        Point mousePoint = { virtualMouse.x, virtualMouse.y };
-        Hex clickedHex = PixelToHex(hexLayout, mousePoint);
-        
-        Tile* tile = GetTileAt(&map, clickedHex);
-        if (tile != NULL) {
-            // Cycle through tile types
-            tile->type = (tile->type + 1) % 5;
-            tile->isWalkable = (tile->type != TILE_WATER && tile->type != TILE_ROCKS);
+
+    // Hovered tile: cached, only recomputed when the mouse leaves the hex or the view changes
+    if (overview.visible && CheckCollisionPointRec(mousePosition, overview.bounds)) hoveredTile = NULL;
+    else hoveredTile = PickTileCached(&pickCache, &map, hexLayout, mainView.camera, mousePosition);
+
+    // Path preview: only searched again when the endpoints or the terrain change
+    int start = (selection.count == 1)? NextSelectedTile(&selection, -1) : -1;
+    int goal = (hoveredTile != NULL)? (int)(hoveredTile - map.tiles) : -1;
+    if (start != pathStart || goal != pathGoal || map.revision != pathRevision)
+    {
+        UpdateHpaGraph(&hpaGraph);  // Recomputes only the sectors touched since the last update
+        pathStart = start;
+        pathGoal = goal;
+        pathRevision = map.revision;
+        pathLength = 0;
+        // Different walkable components: unreachable without searching
+        if (start >= 0 && goal >= 0 && start != goal && IsTileReachable(&walkComponents, map.tiles[start].position, map.tiles[goal].position))
+        {
+            double startTime = GetTime();
+            if (pathHierarchical) pathLength = FindPathHierarchical(&hpaGraph, &pathScratch, map.tiles[start].position, map.tiles[goal].position, pathTiles, map.tileCount, &pathCost);
+            else pathLength = FindPathCached(&pathCache, &pathScratch, &pathProfile, map.tiles[start].position, map.tiles[goal].position, pathTiles, map.tileCount, &pathCost);
+            pathMs = (GetTime() - startTime)*1000.0;
+        }
+    }
+
+    // Movement range: cached, only searched again when the origin or nearby terrain changes
+    if (showMoveRange && start >= 0) UpdateMovementRange(&moveRange, &pathScratch, &pathProfile, map.tiles[start].position, UNIT_MOVE_POINTS);
+    else ClearMovementRange(&moveRange);
+
+    // Field of view: only the bits of the previous view are cleared
+    for (int k = 0; k < sightCount; k++) sightVisible[sightTiles[k] >> 5] &= ~(1u << (sightTiles[k] & 31));
+    sightCount = 0;
+    if (showSight && hoveredTile != NULL) sightCount = ComputeFieldOfView(&map, hoveredTile->position, SIGHT_RADIUS, sightVisible, sightTiles);
+
+    // Fog of war: the scout's move and terrain edits only touch the tiles entering or leaving
+    // a view, and only the bake chunks of those tiles are redrawn
+    if (showFog)
+    {
+        double startTime = GetTime();
+        if (hoveredTile != NULL) MoveFogViewer(&fogOfWar, fogScout, hoveredTile->position);
+        UpdateFogOfWar(&fogOfWar);
+        const int* changes = GetFogChanges(&fogOfWar, &fogChangeCount);
+        for (int k = 0; k < fogChangeCount; k++)
+        {
+            int i = changes[k];
+            fogTint[i] = IsTileVisibleTo(&fogOfWar, 0, i)? WHITE : (IsTileExploredBy(&fogOfWar, 0, i)? FOG_EXPLORED : FOG_UNEXPLORED);
+        }
+        InvalidateTerrainTiles(&terrainBake, changes, fogChangeCount);
+        ClearFogChanges(&fogOfWar);
+        fogMs = (GetTime() - startTime)*1000.0;
+    }
+
+    frameCounter++;
+}
+
+// Sprite rectangle of a tile, centered on its hex
+static Rectangle getTileDestRect(Hex hex)
+{
+    Point center = HexToPixel(hexLayout, hex);
+    return (Rectangle){ center.x - (float)SCALED_TILE_WIDTH/2.0f, center.y - (float)SCALED_TILE_HEIGHT/2.0f,
+                        (float)SCALED_TILE_WIDTH, (float)SCALED_TILE_HEIGHT };
+}
+
+// Redraws highlighted tiles over the baked terrain (inside BeginViewport()): selection,
+// hover and the pending editor stroke. Only tiles inside worldView are submitted.
+static void drawTileHighlights(Rectangle worldView)
+{
+    int submitted = 0;
+    for (int i = NextSelectedTile(&selection, -1); i >= 0; i = NextSelectedTile(&selection, i))
+    {
+        Rectangle dest = getTileDestRect(map.tiles[i].position);
+        if (!CheckCollisionRecs(dest, worldView)) continue;
+
+        // Keep capturing input while large selections are being submitted
+        if (++submitted % INPUT_PUMP_INTERVAL == 0) PumpInputEvents(&inputQueue);
+        DrawTexturePro(tilesetTexture, getTileSourceRect(map.tiles[i].type), dest, (Vector2){0, 0}, 0.0f, YELLOW);
+    }
+
+    // Influence overlay: red, stronger where the selected tiles have more influence
+    if (showInfluence)
+    {
+        for (int i = 0; i < map.tileCount; i++)
+        {
+            float value = GetInfluence(&influenceMap, 0, i);
+            Rectangle dest = getTileDestRect(map.tiles[i].position);
+            if (value <= 0.0f || !CheckCollisionRecs(dest, worldView)) continue;
+            DrawTexturePro(tilesetTexture, getTileSourceRect(map.tiles[i].type), dest, (Vector2){0, 0}, 0.0f, Fade(RED, 0.3f + 0.5f*MIN(value, 1.0f)));
+        }
+    }
+
+    // Movement range: tiles the selected tile can reach with UNIT_MOVE_POINTS
+    for (int k = 0; k < moveRange.count; k++)
+    {
+        int i = moveRange.tiles[k];
+        Rectangle dest = getTileDestRect(map.tiles[i].position);
+        if (map.tiles[i].isSelected || !CheckCollisionRecs(dest, worldView)) continue;
+        DrawTexturePro(tilesetTexture, getTileSourceRect(map.tiles[i].type), dest, (Vector2){0, 0}, 0.0f, SKYBLUE);
+    }
+
+    // Field of view: tiles seen from the hovered tile
+    for (int k = 0; k < sightCount; k++)
+    {
+        int i = sightTiles[k];
+        Rectangle dest = getTileDestRect(map.tiles[i].position);
+        if (map.tiles[i].isSelected || !CheckCollisionRecs(dest, worldView)) continue;
+        DrawTexturePro(tilesetTexture, getTileSourceRect(map.tiles[i].type), dest, (Vector2){0, 0}, 0.0f, GOLD);
+    }
+
+    if (hoveredTile != NULL && !hoveredTile->isSelected)
+    {
+        DrawTexturePro(tilesetTexture, getTileSourceRect(hoveredTile->type), getTileDestRect(hoveredTile->position), (Vector2){0, 0}, 0.0f, LIGHTGRAY);
+    }
+
+    // Cooperative plans, one polyline per unit
+    for (int u = 0; u < coopUnitCount; u++)
+    {
+        const int* plan = coopPaths + u*(COOP_WINDOW + 1);
+        for (int t = 1; t < coopLengths[u]; t++)
+        {
+            if (plan[t] == plan[t - 1]) continue;   // Waiting
+            Point a = HexToPixel(hexLayout, map.tiles[plan[t - 1]].position);
+            Point b = HexToPixel(hexLayout, map.tiles[plan[t]].position);
+            DrawLineEx((Vector2){ a.x, a.y }, (Vector2){ b.x, b.y }, 2.0f, MAGENTA);
+        }
+    }
+
+    // Overlay edges (hyperlanes)
+    for (int e = 0; e < map.overlayCapacity; e++)
+    {
+        const MapOverlayEdge* edge = &map.overlayEdges[e];
+        if (edge->from < 0) continue;
+        Point a = HexToPixel(hexLayout, map.tiles[edge->from].position);
+        Point b = HexToPixel(hexLayout, map.tiles[edge->to].position);
+        DrawLineEx((Vector2){ a.x, a.y }, (Vector2){ b.x, b.y }, 2.0f, Fade(PURPLE, 0.6f));
+    }
+
+    // Path preview through the tile centers
+    for (int k = 1; k < pathLength; k++)
+    {
+        Point a = HexToPixel(hexLayout, map.tiles[pathTiles[k - 1]].position);
+        Point b = HexToPixel(hexLayout, map.tiles[pathTiles[k]].position);
+        DrawLineEx((Vector2){ a.x, a.y }, (Vector2){ b.x, b.y }, 3.0f, ORANGE);
+    }
+
+    // Flow field: one arrow per visible tile pointing at its next step
+    if (flowGoal >= 0)
+    {
+        const FlowField* field = GetFlowField(&flowFields, map.tiles[flowGoal].position);
+        for (int i = 0; i < map.tileCount; i++)
+        {
+            int next = GetFlowFieldStep(&map, field, i);
+            if (next < 0 || !CheckCollisionRecs(getTileDestRect(map.tiles[i].position), worldView)) continue;
+            Point a = HexToPixel(hexLayout, map.tiles[i].position);
+            Point b = HexToPixel(hexLayout, map.tiles[next].position);
+            Vector2 tip = { a.x + (b.x - a.x)*0.4f, a.y + (b.y - a.y)*0.4f };
+            DrawLineEx((Vector2){ a.x, a.y }, tip, 2.0f, DARKBLUE);
+            DrawCircleV(tip, 3.0f, DARKBLUE);
+        }
+    }
+
+    // Pending editor stroke: preview the paint terrain on top
+    if (editor.stroking)
+    {
+        for (int k = 0; k < editor.strokeCount; k++)
+        {
+            Rectangle dest = getTileDestRect(map.tiles[editor.strokeIndices[k]].position);
+            if (!CheckCollisionRecs(dest, worldView)) continue;
+            DrawTexturePro(tilesetTexture, getTileSourceRect(editor.paintType), dest, (Vector2){0, 0}, 0.0f, Fade(WHITE, 0.7f));
         }
     }
 }
@@ -151,56 +1078,121 @@ static void drawGame(void)
         return;
     }
     
-    // Track selected tile for info display
-    Tile* selectedTile = NULL;
-    Point selectedCenter = {0, 0};
-    
-    // Draw all tiles from the map
-    for (int i = 0; i < map.tileCount; i++)
+    // Main view: baked terrain plus per-tile highlights
+    Rectangle worldView = GetViewportWorldBounds(&mainView);
+    BeginViewport(&mainView);
+        DrawTerrainBake(&terrainBake, worldView);
+        drawTileHighlights(worldView);
+    EndViewport();
+
+    // Overview inset: same bake through its own camera, with the main view's frame
+    if (overview.visible)
     {
-        Tile tile = map.tiles[i];
-        
-        // Get hex center
-        Point center = HexToPixel(hexLayout, tile.position);
-        
-        // Track selected tile
-        if (tile.isSelected)
+        BeginViewport(&overview);
+            ClearBackground(RAYWHITE);
+            DrawTerrainBake(&terrainBake, GetViewportWorldBounds(&overview));
+            DrawRectangleLinesEx(worldView, 2.0f/overview.camera.zoom, MAROON);
+        EndViewport();
+        DrawRectangleLinesEx(overview.bounds, 1.0f, DARKGRAY);
+    }
+
+    // Selection drag feedback (virtual screen space)
+    if (dragActive)
+    {
+        if (lassoMode)
         {
-            selectedTile = &map.tiles[i];
-            selectedCenter = center;
+            for (int i = 1; i < lassoPointCount; i++) DrawLineV(lassoPoints[i - 1], lassoPoints[i], DARKBLUE);
+            DrawLineV(lassoPoints[lassoPointCount - 1], lassoPoints[0], Fade(DARKBLUE, 0.4f));
         }
-        
-        // Get source rectangle from tileset
-        Rectangle sourceRect = getTileSourceRect(tile.type);
-        
-        // Calculate destination rectangle (centered on hex position)
-        // Use scaled tile dimensions
-        Rectangle destRect = {
-            center.x - (float)SCALED_TILE_WIDTH / 2.0f,
-            center.y - (float)SCALED_TILE_HEIGHT / 2.0f,
-            (float)SCALED_TILE_WIDTH,
-            (float)SCALED_TILE_HEIGHT
-        };
-        
-        // Tint color (highlight if selected)
-        Color tint = WHITE;
-        if (tile.isSelected)
+        else
         {
-            tint = YELLOW;  // Tint selected tiles yellow
+            Vector2 mouse = mousePosition;
+            Rectangle box = { MIN(dragStart.x, mouse.x), MIN(dragStart.y, mouse.y),
+                              fabsf(mouse.x - dragStart.x), fabsf(mouse.y - dragStart.y) };
+            DrawRectangleRec(box, Fade(SKYBLUE, 0.2f));
+            DrawRectangleLinesEx(box, 1.0f, DARKBLUE);
         }
-        
-        // Draw the tile texture
-        DrawTexturePro(tilesetTexture, sourceRect, destRect, (Vector2){0, 0}, 0.0f, tint);
     }
     
     // Top info
-    DrawText(TextFormat("Map Tiles: %d | Left-click: select | Right-click: change terrain", 
+    DrawText(TextFormat("Map Tiles: %d | Left: select/drag box (Ctrl: lasso) | Right: terrain", 
              map.tileCount), 10, 10, 20, BLACK);
+
+    // Hover tooltip
+    if (hoveredTile != NULL)
+    {
+        DrawText(TextFormat("Hover: (q:%d, r:%d, s:%d) type %d | P: %s picking", 
+                 hoveredTile->position.q, hoveredTile->position.r, hoveredTile->position.s, hoveredTile->type,
+                 (pickCache.mask != NULL)? "sprite" : "hex"),
+                 10, 35, 20, DARKGRAY);
+    }
     
+    // Path preview info
+    if (pathStart >= 0 && pathGoal >= 0 && pathStart != pathGoal)
+    {
+        if (pathLength > 0) DrawText(TextFormat("Path (%s, H): %d tiles, cost %d (%.3f ms) | Cache: %d hits, %d misses", pathHierarchical? "HPA*" : "A*", pathLength, pathCost, pathMs, pathCache.hits, pathCache.misses), 10, 75, 10, ORANGE);
+        else DrawText(TextFormat("Path: unreachable (%d walkable components)", walkComponents.componentCount), 10, 75, 10, ORANGE);
+    }
+
+    // Batch path info
+    if (batchQueryCount > 0)
+    {
+        DrawText(TextFormat("Batch (T): %d/%d paths reached in %.3f ms on %d workers", batchReached, batchQueryCount, batchMs, GetWorkerCount(&workerPool)), 10, 90, 10, DARKBLUE);
+    }
+
+    // Influence overlay info
+    if (showInfluence)
+    {
+        DrawText(TextFormat("Influence (I): %d sources, updated in %.3f ms", influenceMap.sourceCount[0], influenceMs), 10, 105, 10, RED);
+    }
+
+    // Cooperative plan info
+    if (coopUnitCount > 0)
+    {
+        DrawText(TextFormat("Cooperative (C): %d/%d units reach the goal within %d steps, planned in %.3f ms", coopReached, coopUnitCount, COOP_WINDOW, coopMs), 10, 120, 10, MAGENTA);
+    }
+
+    // Fog of war info
+    if (showFog)
+    {
+        DrawText(TextFormat("Fog (X): %d tiles changed visibility, updated in %.3f ms", fogChangeCount, fogMs), 10, 135, 10, DARKGRAY);
+    }
+
+    // Entity turn info
+    if (turnNumber > 0)
+    {
+        DrawText(TextFormat("Turn %d (N): %d entities in %d archetypes, %d fleets lost, systems ran in %.3f ms | Treasury: %d",
+                 turnNumber, GetEntityCount(&world), world.archetypeCount, turnLosses, turnMs, treasury[0]), 10, 150, 10, DARKGREEN);
+        if (hoveredTile != NULL)
+        {
+            DrawText(TextFormat("Hovered tile: %d entities, %d within %d tiles", GetOccupantCount(&occupancy, (int)(hoveredTile - map.tiles)),
+                     QueryOccupantsInRange(&occupancy, hoveredTile->position, NEARBY_RADIUS, NULL, 0), NEARBY_RADIUS), 10, 165, 10, DARKGREEN);
+        }
+    }
+
+    // Editor status
+    if (editor.enabled)
+    {
+        static const char* toolNames[] = { "Brush", "Line", "Fill" };
+        DrawText(TextFormat("EDITOR [E] | Tool: %s (B/L/F) | Terrain: %d (1-5) | Radius: %d ([ ]) | Last stroke: %d tiles",
+                 toolNames[editor.tool], editor.paintType + 1, editor.brushRadius, lastStrokeTiles), 10, 60, 10, MAROON);
+    }
+
     // Bottom info - show selected tile coordinates
-    if (selectedTile != NULL)
+    if (selectedEntityCount > 0)
     {
-        DrawText(TextFormat("Selected Tile - Cube: (q:%d, r:%d, s:%d) | Screen: (%.1f, %.1f)", 
+        DrawText(TextFormat("Selected Entities: %d", selectedEntityCount), 10, gameScreenHeight - 30, 20, DARKGREEN);
+    }
+    else if (selection.count > 1)
+    {
+        DrawText(TextFormat("Selected Tiles: %d (last selection: %.3f ms)", selection.count, lastSelectionMs),
+                 10, gameScreenHeight - 30, 20, DARKGREEN);
+    }
+    else if (selection.count == 1)
+    {
+        Tile* selectedTile = &map.tiles[NextSelectedTile(&selection, -1)];
+        Point selectedCenter = HexToPixel(hexLayout, selectedTile->position);
+        DrawText(TextFormat("Selected Tile - Cube: (q:%d, r:%d, s:%d) | World: (%.1f, %.1f)", 
                  selectedTile->position.q, selectedTile->position.r, selectedTile->position.s,
                  selectedCenter.x, selectedCenter.y), 
                  10, gameScreenHeight - 30, 20, DARKGREEN);
@@ -210,10 +1202,139 @@ static void drawGame(void)
         DrawText("No tile selected", 10, gameScreenHeight - 30, 20, GRAY);
     }
 }
+
+static void unloadGame(void)
+{
+    UnloadPickMask(&pickMask);          // Free picking lookup
+    DestroyEntityPickGrid(&entityPickGrid); // Free entity pick buckets
+    DestroyMapEditor(&editor);          // Free editor stroke buffers
+    DestroyPathScratch(&pathScratch);   // Free pathfinding state
+    UnloadPathCache(&pathCache);        // Free cached paths
+    UnloadWalkableComponents(&walkComponents); // Free component labels
+    UnloadHpaGraph(&hpaGraph);          // Free hierarchical path graph
+    UnloadFlowFieldCache(&flowFields);  // Free cached flow fields
+    DestroyPathBatch(&pathBatch);       // Free batch search state
+    UnloadMovementRange(&moveRange);    // Free movement range buffers
+    UnloadInfluenceMap(&influenceMap);  // Free influence planes
+    UnloadCoopPlanner(&coopPlanner);    // Free reservations and space-time search state
+    free(coopPaths);
+    free(coopLengths);
+    free(sightVisible);
+    free(sightTiles);
+    UnloadFogOfWar(&fogOfWar);          // Free view counts and visibility bitsets
+    free(fogTint);
+    UnloadEcsWorld(&world);             // Free entity archetypes and records
+    UnloadOccupancyIndex(&occupancy);
+    UnloadWorkerPool(&workerPool);      // Stop worker threads
+    free(batchQueries);
+    free(pathTiles);
+    DestroyUndoHistory(&undoHistory);   // Free terrain undo chunks
+    DestroyFloodFill(&regionFill);      // Free region query buffers
+    DestroyTileSelection(&selection);   // Free selection bitset
+    DestroyMap(&map);                   // Free map memory
+}
+
+static unsigned int hashBytes(unsigned int hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i])*16777619u;
+    return hash;
+}
+
+// Entities of the turn demo: handle, tile and (for fleets) health, in archetype row order
+static void checksumEntitySystem(EcsWorld* ecs, const EcsView* view, void* userData)
+{
+    (void)ecs;
+    unsigned int* hash = (unsigned int*)userData;
+    const UnitPosition* position = (const UnitPosition*)GetEcsColumn(view, positionComponent);
+    const UnitHealth* health = (const UnitHealth*)GetEcsColumn(view, healthComponent);
+    for (int i = 0; i < view->count; i++)
+    {
+        *hash = hashBytes(*hash, &view->entities[i], sizeof(Entity));
+        *hash = hashBytes(*hash, &position[i].tile, sizeof(int));
+        if (health != NULL) *hash = hashBytes(*hash, &health[i].health, sizeof(int));
+    }
+}
+
+// FNV-1a hash over everything the input can change, so replays can be compared across runs
+static unsigned int getGameChecksum(void)
+{
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < map.tileCount; i++)
+    {
+        hash = (hash ^ (unsigned int)map.tiles[i].type)*16777619u;
+        hash = (hash ^ (unsigned int)map.tiles[i].isSelected)*16777619u;
+
+        // Overlay edges (W) in list order, which follows the order they were added
+        for (int e = FirstOverlayEdgeFrom(&map, i); e >= 0; e = map.overlayEdges[e].nextOut)
+        {
+            hash = hashBytes(hash, &map.overlayEdges[e].to, sizeof(int));
+            hash = hashBytes(hash, &map.overlayEdges[e].cost, sizeof(int));
+        }
+    }
+    float cameraState[5] = { mainView.camera.target.x, mainView.camera.target.y, mainView.camera.offset.x, mainView.camera.offset.y, mainView.camera.zoom };
+    hash = hashBytes(hash, cameraState, sizeof(cameraState));
+
+    // Entity demo (N)
+    hash = hashBytes(hash, &turnNumber, sizeof(turnNumber));
+    hash = hashBytes(hash, treasury, sizeof(treasury));
+    RunEcsSystem(&world, ECS_MASK(positionComponent), 0, checksumEntitySystem, &hash);
+    return hash;
+}
+
+// Headless benchmark: feeds a recorded input stream through updateGame() without a window
+static int runReplay(const char* fileName)
+{
+    recording = LoadInputRecording(fileName);
+    if (recording.records == NULL)
+    {
+        TraceLog(LOG_ERROR, "Failed to load input recording: %s", fileName);
+        return 1;
+    }
+
+    initGame(recording.seed);
+
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    for (unsigned int frame = 0; frame < recording.frameCount; frame++)
+    {
+        ReplayInputFrame(&recording, frame, &inputQueue);
+
+        // Wall clock: clock() would sum the CPU time of every worker thread
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        updateGame();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double frameMs = (end.tv_sec - start.tv_sec)*1000.0 + (end.tv_nsec - start.tv_nsec)/1000000.0;
+
+        totalMs += frameMs;
+        if (frameMs > worstMs) worstMs = frameMs;
+    }
+
+    printf("Replay %s: %u frames, %d events, update total %.3f ms, avg %.4f ms, worst %.3f ms, checksum %08x\n",
+           fileName, recording.frameCount, recording.count, totalMs,
+           (recording.frameCount > 0)? totalMs/recording.frameCount : 0.0, worstMs, getGameChecksum());
+
+    unloadGame();
+    UnloadInputRecording(&recording);
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char* argv[])
 {
+    // Command line: --record <file> saves the consumed input stream on exit,
+    //               --replay <file> runs a recorded stream headless and prints timings
+    const char* recordFile = NULL;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--replay") == 0) return runReplay(argv[i + 1]);
+        if (strcmp(argv[i], "--record") == 0) recordFile = argv[++i];
+    }
+    recordingEnabled = (recordFile != NULL);
+
     const int screenWidth = 800;
     const int screenHeight = 450;
 
@@ -226,7 +1347,10 @@ int main(void)
     RenderTexture2D target = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
     SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);  // Texture scale filter to use
 
-    initGame();
+    // InitWindow() seeded raylib's generator; reseed with a seed the recording can store
+    recording.seed = (unsigned int)time(NULL);
+    initGame(recording.seed);
+    loadTileset();
 
     SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
   
@@ -236,8 +1360,14 @@ int main(void)
         // Compute scaling for letterboxing
         float scale = getScreenScale();
 
+        CaptureInputEvents(&inputQueue);  // EndDrawing() polled raylib at the end of the last frame
         updateGame();
 
+        // Bake terrain chunks the viewports are about to show (cannot nest inside BeginTextureMode)
+        Rectangle worldViews[2] = { GetViewportWorldBounds(&mainView), GetViewportWorldBounds(&overview) };
+        UpdateTerrainBake(&terrainBake, worldViews, overview.visible? 2 : 1);
+        PumpInputEvents(&inputQueue);   // Chunk bakes can take a while after big edits
+
         // Draw to render texture
         BeginTextureMode(target);
             drawGame();
@@ -255,8 +1385,15 @@ int main(void)
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    if (recordingEnabled)
+    {
+        if (!SaveInputRecording(&recording, frameCounter, recordFile)) TraceLog(LOG_ERROR, "Failed to save input recording: %s", recordFile);
+        UnloadInputRecording(&recording);
+    }
+
+    UnloadTerrainBake(&terrainBake);    // Unload baked terrain chunks
     UnloadTexture(tilesetTexture);      // Unload tileset texture
-    DestroyMap(&map);                   // Free map memory
+    unloadGame();                       // Free map and selection memory
     UnloadRenderTexture(target);        // Unload render texture
 
     CloseWindow();                      // Close window and OpenGL context
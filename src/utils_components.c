@@ -0,0 +1,428 @@
+/*
+    This is a utility file for connected-component labels over the walkable tiles of a hex map.
+
+    Every walkable tile carries a component label, so "can B be reached from A at all?" is
+    answered by comparing two labels instead of running a search that fails slowly on
+    unreachable goals. Overlay edges (hyperlanes, wormholes) link tiles like sides do; their
+    direction is ignored, so with one-way edges a shared label only means the tiles are
+    connected one way or the other. Labels are kept up to date from map change notifications:
+
+    - A tile becoming walkable gets a new label and is merged with the components of its
+      walkable neighbours. Labels are nodes of a union-find forest (union by size, path
+      halving), so a merge never relabels tiles. A new overlay edge merges its two ends.
+    - A tile becoming unwalkable may split its component. Its walkable neighbours are first
+      grouped by adjacency around the ring (neighbouring ring tiles stay connected), which
+      settles most cases at once; the far ends of its overlay edges are groups of their own.
+      Otherwise the remaining groups are grown by interleaved breadth-first searches until
+      they meet or one of them runs out of tiles: a group that runs out is a separate piece
+      and gets a new label. The work is bounded by the size of the smallest piece that broke
+      off (or the detour joining the groups), not the map. Removing the last overlay edge
+      between two tiles runs the same search from its two ends.
+
+    Very large change batches, and running out of label ids, fall back to relabeling the
+    whole map.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitWalkableComponents: Labels a map and starts tracking its changes.
+    - UnloadWalkableComponents: Frees the labels and unregisters from the map.
+    - GetWalkableComponent: Returns the component label of a tile.
+    - IsTileReachable: O(1) check whether a path between two hexes can exist.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - WalkableComponents: Per-tile labels, union-find forest and split search state.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+#define COMPONENT_SPLIT_GROUPS 8        // Groups searched at once; a split with more relabels everything
+#define COMPONENT_MAX_LINKS (6 + 2 * MAX_TILE_OVERLAY_EDGES)   // Neighbours plus overlay edge ends of one tile
+#define COMPONENT_REBUILD_DIVISOR 16    // Relabel everything if a batch changes more than 1/16 of the map
+
+typedef struct ComponentQueue {
+    int* tiles;             // Tiles reached by one split search, in visit order
+    int count;
+    int head;               // Next tile to expand
+    int capacity;
+} ComponentQueue;
+
+typedef struct WalkableComponents {
+    Map* map;
+    int* label;             // Per tile: union-find node, -1 for unwalkable tiles
+    int* parent;            // Union-find forest over label ids
+    int* size;              // Tiles per root
+    int idCapacity;
+    int nextId;             // First unused label id
+    int componentCount;     // Components currently on the map
+
+    // Split search state
+    unsigned int* visitStamp;
+    unsigned char* visitGroup;
+    unsigned int searchStamp;
+    ComponentQueue queues[COMPONENT_SPLIT_GROUPS];
+} WalkableComponents;
+
+static int findComponentRoot(WalkableComponents* components, int id) {
+    while (components->parent[id] != id) {
+        components->parent[id] = components->parent[components->parent[id]];
+        id = components->parent[id];
+    }
+    return id;
+}
+
+// Root label of a tile, -1 if it is not walkable
+int GetWalkableComponent(WalkableComponents* components, int tileIndex) {
+    int id = components->label[tileIndex];
+    if (id < 0) {
+        return -1;
+    }
+    int root = findComponentRoot(components, id);
+    components->label[tileIndex] = root;
+    return root;
+}
+
+static bool isComponentTile(const WalkableComponents* components, int tileIndex) {
+    return tileIndex >= 0 && components->label[tileIndex] >= 0;
+}
+
+// Tiles linked to a tile: its neighbours on the map and the other ends of its overlay edges
+// in either direction. Returns the count (at most COMPONENT_MAX_LINKS).
+static int componentLinks(const Map* map, int tileIndex, int* links) {
+    int count = 0;
+    Hex hex = map->tiles[tileIndex].position;
+    for (int dir = 0; dir < 6; dir++) {
+        int neighbor = GetTileIndex(map, HexNeighbor(hex, dir));
+        if (neighbor >= 0) links[count++] = neighbor;
+    }
+    for (int e = FirstOverlayEdgeFrom(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextOut) {
+        links[count++] = map->overlayEdges[e].to;
+    }
+    for (int e = FirstOverlayEdgeTo(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextIn) {
+        links[count++] = map->overlayEdges[e].from;
+    }
+    return count;
+}
+
+// Relabels the whole map with breadth-first searches (label ids restart at 0)
+static void rebuildWalkableComponents(WalkableComponents* components) {
+    const Map* map = components->map;
+    int* queue = components->queues[0].tiles;   // Sized for the whole map by the caller
+    for (int i = 0; i < map->tileCount; i++) components->label[i] = -1;
+    components->nextId = 0;
+    components->componentCount = 0;
+
+    for (int seed = 0; seed < map->tileCount; seed++) {
+        if (!map->tiles[seed].isWalkable || components->label[seed] >= 0) continue;
+
+        int id = components->nextId++;
+        int count = 0;
+        queue[count++] = seed;
+        components->label[seed] = id;
+        for (int head = 0; head < count; head++) {
+            int links[COMPONENT_MAX_LINKS];
+            int linkCount = componentLinks(map, queue[head], links);
+            for (int l = 0; l < linkCount; l++) {
+                int neighbor = links[l];
+                if (!map->tiles[neighbor].isWalkable || components->label[neighbor] >= 0) continue;
+                components->label[neighbor] = id;
+                queue[count++] = neighbor;
+            }
+        }
+        components->parent[id] = id;
+        components->size[id] = count;
+        components->componentCount++;
+    }
+}
+
+static bool pushComponentQueue(ComponentQueue* queue, int tileIndex) {
+    if (queue->count == queue->capacity) {
+        int capacity = queue->capacity * 2;
+        int* tiles = (int*)realloc(queue->tiles, capacity * sizeof(int));
+        if (tiles == NULL) {
+            return false;
+        }
+        queue->tiles = tiles;
+        queue->capacity = capacity;
+    }
+    queue->tiles[queue->count++] = tileIndex;
+    return true;
+}
+
+// Unites the components of two labeled tiles
+static void mergeComponents(WalkableComponents* components, int tileA, int tileB) {
+    int a = GetWalkableComponent(components, tileA);
+    int b = GetWalkableComponent(components, tileB);
+    if (a == b) {
+        return;
+    }
+    if (components->size[a] < components->size[b]) { int t = a; a = b; b = t; }
+    components->parent[b] = a;
+    components->size[a] += components->size[b];
+    components->componentCount--;
+}
+
+// Walkable tile added: new singleton component merged with its neighbours' components
+static void addComponentTile(WalkableComponents* components, int tileIndex) {
+    int id = components->nextId++;
+    components->parent[id] = id;
+    components->size[id] = 1;
+    components->label[tileIndex] = id;
+    components->componentCount++;
+
+    int links[COMPONENT_MAX_LINKS];
+    int linkCount = componentLinks(components->map, tileIndex, links);
+    for (int l = 0; l < linkCount; l++) {
+        if (isComponentTile(components, links[l])) mergeComponents(components, tileIndex, links[l]);
+    }
+}
+
+// Checks whether the seed tiles of component oldRoot are still connected: one interleaved
+// search per seed until the searches meet or run out of tiles, and every set of searches that
+// runs out gets a new label. Returns false if there are more than COMPONENT_SPLIT_GROUPS
+// seeds, a search buffer could not grow or label ids ran out (the caller then relabels
+// everything).
+static bool splitComponent(WalkableComponents* components, const int* seeds, int seedCount, int oldRoot) {
+    const Map* map = components->map;
+    components->searchStamp++;
+    if (components->searchStamp == 0) {
+        for (int i = 0; i < map->tileCount; i++) components->visitStamp[i] = 0;
+        components->searchStamp = 1;
+    }
+
+    // 'set' merges groups whose searches met
+    int set[COMPONENT_SPLIT_GROUPS];
+    bool open[COMPONENT_SPLIT_GROUPS];
+    int groupCount = 0;
+    for (int i = 0; i < seedCount; i++) {
+        if (components->visitStamp[seeds[i]] == components->searchStamp) continue;     // Same tile listed twice
+        if (groupCount == COMPONENT_SPLIT_GROUPS) {
+            return false;
+        }
+        int g = groupCount++;
+        ComponentQueue* queue = &components->queues[g];
+        queue->count = 0;
+        queue->head = 0;
+        pushComponentQueue(queue, seeds[i]);
+        components->visitStamp[seeds[i]] = components->searchStamp;
+        components->visitGroup[seeds[i]] = (unsigned char)g;
+        set[g] = g;
+        open[g] = true;
+    }
+
+    int setCount = groupCount;
+    while (setCount > 1) {
+        for (int g = 0; g < groupCount && setCount > 1; g++) {
+            if (!open[g]) continue;
+            ComponentQueue* queue = &components->queues[g];
+
+            if (queue->head == queue->count) {
+                // Search exhausted: unless another open group shares its set, the set is a piece
+                open[g] = false;
+                bool setOpen = false;
+                for (int o = 0; o < groupCount; o++) {
+                    if (open[o] && set[o] == set[g]) setOpen = true;
+                }
+                if (setOpen) continue;
+
+                if (components->nextId >= components->idCapacity) {
+                    return false;   // Out of label ids
+                }
+                int id = components->nextId++;
+                int count = 0;
+                for (int o = 0; o < groupCount; o++) {
+                    if (set[o] != set[g]) continue;
+                    for (int k = 0; k < components->queues[o].count; k++) components->label[components->queues[o].tiles[k]] = id;
+                    count += components->queues[o].count;
+                }
+                components->parent[id] = id;
+                components->size[id] = count;
+                components->size[oldRoot] -= count;
+                components->componentCount++;
+                setCount--;
+                continue;
+            }
+
+            int current = queue->tiles[queue->head++];
+            int links[COMPONENT_MAX_LINKS];
+            int linkCount = componentLinks(map, current, links);
+            for (int l = 0; l < linkCount; l++) {
+                int neighbor = links[l];
+                if (!isComponentTile(components, neighbor)) continue;
+                if (components->visitStamp[neighbor] == components->searchStamp) {
+                    int other = set[components->visitGroup[neighbor]];
+                    if (other != set[g]) {
+                        // The searches met: merge their sets
+                        int merged = set[g];
+                        for (int o = 0; o < groupCount; o++) {
+                            if (set[o] == other) set[o] = merged;
+                        }
+                        setCount--;
+                    }
+                    continue;
+                }
+                components->visitStamp[neighbor] = components->searchStamp;
+                components->visitGroup[neighbor] = (unsigned char)g;
+                if (!pushComponentQueue(queue, neighbor)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Walkable tile removed (its label is already -1): finds the pieces its component broke into.
+// Returns false if the split search failed (the caller then relabels everything).
+static bool removeComponentTile(WalkableComponents* components, int tileIndex, int oldRoot) {
+    const Map* map = components->map;
+    Hex hex = map->tiles[tileIndex].position;
+
+    // Group the remaining neighbours: consecutive ring tiles are adjacent to each other
+    int ring[6];
+    for (int dir = 0; dir < 6; dir++) {
+        int neighbor = GetTileIndex(map, HexNeighbor(hex, dir));
+        ring[dir] = isComponentTile(components, neighbor) ? neighbor : -1;
+    }
+    int seeds[COMPONENT_MAX_LINKS];
+    int groupCount = 0;
+    for (int dir = 0; dir < 6; dir++) {
+        if (ring[dir] >= 0 && ring[(dir + 5) % 6] < 0) seeds[groupCount++] = ring[dir];
+    }
+    if (groupCount == 0 && ring[0] >= 0) seeds[groupCount++] = ring[0];     // Full ring
+
+    // The far ends of overlay edges are only linked to the ring through the removed tile
+    for (int e = FirstOverlayEdgeFrom(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextOut) {
+        if (isComponentTile(components, map->overlayEdges[e].to)) seeds[groupCount++] = map->overlayEdges[e].to;
+    }
+    for (int e = FirstOverlayEdgeTo(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextIn) {
+        if (isComponentTile(components, map->overlayEdges[e].from)) seeds[groupCount++] = map->overlayEdges[e].from;
+    }
+
+    components->size[oldRoot]--;
+    if (groupCount == 0) {
+        components->componentCount--;   // The tile was a component of its own
+        return true;
+    }
+    if (groupCount == 1) {
+        return true;    // One group: still connected
+    }
+    return splitComponent(components, seeds, groupCount, oldRoot);
+}
+
+// Overlay edge between two tiles added or removed: merge their components, or check whether
+// the last link between them was removed
+static bool updateComponentLink(WalkableComponents* components, int tileA, int tileB) {
+    const Map* map = components->map;
+    if (!isComponentTile(components, tileA) || !isComponentTile(components, tileB)) {
+        return true;
+    }
+    if (FindOverlayEdge(map, tileA, tileB) >= 0 || FindOverlayEdge(map, tileB, tileA) >= 0) {
+        mergeComponents(components, tileA, tileB);
+        return true;
+    }
+    int root = GetWalkableComponent(components, tileA);
+    if (root != GetWalkableComponent(components, tileB)) {
+        return true;
+    }
+    int seeds[2] = { tileA, tileB };
+    return splitComponent(components, seeds, 2, root);
+}
+
+static void onComponentsMapChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    WalkableComponents* components = (WalkableComponents*)userData;
+    if (kind == MAP_CHANGE_OVERLAY) {
+        if (components->nextId + 2 > components->idCapacity || !updateComponentLink(components, tileIndices[0], tileIndices[1])) {
+            rebuildWalkableComponents(components);
+        }
+        return;
+    }
+    // A removal can split off up to COMPONENT_SPLIT_GROUPS - 1 pieces (ring groups plus overlay
+    // edge ends), each with a new label id; an addition takes one
+    if (count > map->tileCount / COMPONENT_REBUILD_DIVISOR || components->nextId + (COMPONENT_SPLIT_GROUPS - 1) * count > components->idCapacity) {
+        rebuildWalkableComponents(components);
+        return;
+    }
+
+    // One tile at a time, removals first: tiles added by this batch stay unlabeled (and are
+    // not searched through) until all removals are settled
+    for (int i = 0; i < count; i++) {
+        int index = tileIndices[i];
+        if (map->tiles[index].isWalkable || components->label[index] < 0) continue;
+        int oldRoot = GetWalkableComponent(components, index);
+        components->label[index] = -1;
+        if (!removeComponentTile(components, index, oldRoot)) {
+            rebuildWalkableComponents(components);
+            return;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        int index = tileIndices[i];
+        if (map->tiles[index].isWalkable && components->label[index] < 0) {
+            addComponentTile(components, index);
+        }
+    }
+}
+
+void InitWalkableComponents(WalkableComponents* components, Map* map) {
+    *components = (WalkableComponents){ 0 };
+    components->map = map;
+    components->idCapacity = 2 * map->tileCount;
+    components->label = (int*)malloc(map->tileCount * sizeof(int));
+    components->parent = (int*)malloc(components->idCapacity * sizeof(int));
+    components->size = (int*)malloc(components->idCapacity * sizeof(int));
+    components->visitStamp = (unsigned int*)calloc(map->tileCount, sizeof(unsigned int));
+    components->visitGroup = (unsigned char*)malloc(map->tileCount * sizeof(unsigned char));
+    for (int g = 0; g < COMPONENT_SPLIT_GROUPS; g++) {
+        ComponentQueue* queue = &components->queues[g];
+        queue->capacity = (g == 0) ? map->tileCount : 256;  // Queue 0 doubles as the rebuild queue
+        queue->tiles = (int*)malloc(queue->capacity * sizeof(int));
+    }
+    rebuildWalkableComponents(components);
+    AddMapChangeListener(map, onComponentsMapChanged, components);
+}
+
+void UnloadWalkableComponents(WalkableComponents* components) {
+    if (components->map == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(components->map, onComponentsMapChanged, components);
+    free(components->label);
+    free(components->parent);
+    free(components->size);
+    free(components->visitStamp);
+    free(components->visitGroup);
+    for (int g = 0; g < COMPONENT_SPLIT_GROUPS; g++) {
+        free(components->queues[g].tiles);
+    }
+    *components = (WalkableComponents){ 0 };
+}
+
+// Whether a path from start to goal can exist, in O(1): false guarantees that FindPath()
+// fails for every profile; true means the goal is reachable for profiles that can enter
+// every walkable terrain (unless one-way overlay edges point the wrong way). Like
+// FindPath(), the start tile itself does not need to be walkable.
+bool IsTileReachable(WalkableComponents* components, Hex start, Hex goal) {
+    const Map* map = components->map;
+    int startIndex = GetTileIndex(map, start);
+    int goalIndex = GetTileIndex(map, goal);
+    if (startIndex < 0 || goalIndex < 0) {
+        return false;
+    }
+    if (startIndex == goalIndex) {
+        return true;
+    }
+
+    int target = GetWalkableComponent(components, goalIndex);
+    if (target < 0) {
+        return false;
+    }
+    if (isComponentTile(components, startIndex)) {
+        return GetWalkableComponent(components, startIndex) == target;
+    }
+    int links[COMPONENT_MAX_LINKS];
+    int linkCount = componentLinks(map, startIndex, links);
+    for (int l = 0; l < linkCount; l++) {
+        if (isComponentTile(components, links[l]) && GetWalkableComponent(components, links[l]) == target) return true;
+    }
+    return false;
+}
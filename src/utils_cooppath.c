@@ -0,0 +1,309 @@
+/*
+    This is a utility file for cooperative pathfinding: many units planning moves for the
+    same turn without running into each other (windowed cooperative A*).
+
+    Every unit plans in space-time: a search state is a (tile, time step) pair, and each step
+    either moves to a neighbour (or across an overlay edge) or waits in place. Planned states
+    go into a reservation table that later units treat as blocked, and a move is also refused
+    if it would swap tiles with a unit coming the other way. Units plan one after another, so
+    each plan costs one search against the table instead of a check against every other unit.
+
+    Plans only look a fixed window of time steps ahead; a unit that cannot reach its goal
+    within the window gets the best partial plan towards it and plans again next turn. Only
+    reserved states are stored, in an open-addressing hash table keyed by (tile, time), so the
+    table grows with units * window, not with the map. Search states live in a second hash
+    table that is reset per search with a stamp; the open set reuses the heap helpers of
+    utils_pathfinding.c with space-time states as node ids.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitCoopPlanner: Allocates the reservation table and search state for a map.
+    - UnloadCoopPlanner: Frees the planner.
+    - ClearCoopReservations: Drops every reservation (call when a new turn starts).
+    - PlanCoopPath: Plans and reserves the moves of one unit for the window.
+    - GetCoopReservation: Returns the unit holding a tile at a time step.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - SpaceTimeHash: Open-addressing hash table from (tile, time) keys to ints.
+    - CoopPlanner: Reservation table, space-time search states and settings.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+#define COOP_MAX_WINDOW 32          // Longest planning window in time steps
+#define COOP_MAX_NODES 65536        // Space-time states one search may create
+#define COOP_NO_UNIT -1             // GetCoopReservation() result for a free state
+
+typedef struct SpaceTimeHash {
+    unsigned int* keys;         // tile * (COOP_MAX_WINDOW + 1) + time
+    int* values;
+    unsigned int* stamps;       // A slot is in use if its stamp equals stamp
+    unsigned int stamp;
+    int capacity;               // Power of two
+    int count;
+} SpaceTimeHash;
+
+typedef struct CoopPlanner {
+    const Map* map;
+    PathProfile profile;
+    int window;                 // Time steps planned ahead
+    SpaceTimeHash reservations; // (tile, time) -> unit
+    SpaceTimeHash nodeIndex;    // (tile, time) -> search state of the current search
+    int* nodeTile;              // Per search state: tile and time
+    unsigned char* nodeTime;
+    int nodeCount;
+    PathScratch scratch;        // Costs and open set over search states
+    int expanded;               // States expanded by the last plan
+} CoopPlanner;
+
+static inline unsigned int spaceTimeKey(int tileIndex, int time) {
+    return (unsigned int)tileIndex * (COOP_MAX_WINDOW + 1) + (unsigned int)time;
+}
+
+static inline unsigned int spaceTimeSlot(const SpaceTimeHash* hash, unsigned int key) {
+    key ^= key >> 16;
+    key *= 0x7feb352du;
+    key ^= key >> 15;
+    key *= 0x846ca68bu;
+    key ^= key >> 16;
+    return key & (unsigned int)(hash->capacity - 1);
+}
+
+static bool initSpaceTimeHash(SpaceTimeHash* hash, int capacity) {
+    *hash = (SpaceTimeHash){ 0 };
+    hash->keys = (unsigned int*)malloc(capacity * sizeof(unsigned int));
+    hash->values = (int*)malloc(capacity * sizeof(int));
+    hash->stamps = (unsigned int*)calloc(capacity, sizeof(unsigned int));
+    hash->stamp = 1;
+    hash->capacity = capacity;
+    return hash->keys != NULL && hash->values != NULL && hash->stamps != NULL;
+}
+
+static void freeSpaceTimeHash(SpaceTimeHash* hash) {
+    free(hash->keys);
+    free(hash->values);
+    free(hash->stamps);
+    *hash = (SpaceTimeHash){ 0 };
+}
+
+// Empties the table in O(1): slots of older stamps count as free
+static void clearSpaceTimeHash(SpaceTimeHash* hash) {
+    hash->stamp++;
+    if (hash->stamp == 0) {
+        for (int i = 0; i < hash->capacity; i++) hash->stamps[i] = 0;
+        hash->stamp = 1;
+    }
+    hash->count = 0;
+}
+
+static int findSpaceTime(const SpaceTimeHash* hash, unsigned int key) {
+    unsigned int mask = (unsigned int)(hash->capacity - 1);
+    for (unsigned int slot = spaceTimeSlot(hash, key); hash->stamps[slot] == hash->stamp; slot = (slot + 1) & mask) {
+        if (hash->keys[slot] == key) return hash->values[slot];
+    }
+    return -1;
+}
+
+static bool insertSpaceTime(SpaceTimeHash* hash, unsigned int key, int value);
+
+// Doubles the capacity and reinserts the entries in use
+static bool growSpaceTimeHash(SpaceTimeHash* hash) {
+    SpaceTimeHash grown;
+    if (!initSpaceTimeHash(&grown, 2 * hash->capacity)) {
+        freeSpaceTimeHash(&grown);
+        return false;
+    }
+    for (int i = 0; i < hash->capacity; i++) {
+        if (hash->stamps[i] == hash->stamp) insertSpaceTime(&grown, hash->keys[i], hash->values[i]);
+    }
+    freeSpaceTimeHash(hash);
+    *hash = grown;
+    return true;
+}
+
+// Sets the value of a key (tables are kept at most half full)
+static bool insertSpaceTime(SpaceTimeHash* hash, unsigned int key, int value) {
+    if (2 * (hash->count + 1) > hash->capacity && !growSpaceTimeHash(hash)) {
+        return false;
+    }
+    unsigned int mask = (unsigned int)(hash->capacity - 1);
+    unsigned int slot = spaceTimeSlot(hash, key);
+    while (hash->stamps[slot] == hash->stamp && hash->keys[slot] != key) slot = (slot + 1) & mask;
+    if (hash->stamps[slot] != hash->stamp) {
+        hash->stamps[slot] = hash->stamp;
+        hash->keys[slot] = key;
+        hash->count++;
+    }
+    hash->values[slot] = value;
+    return true;
+}
+
+// Plans look window time steps ahead (clamped to [1, COOP_MAX_WINDOW])
+void InitCoopPlanner(CoopPlanner* planner, const Map* map, PathProfile profile, int window) {
+    *planner = (CoopPlanner){ 0 };
+    if (window < 1) window = 1;
+    if (window > COOP_MAX_WINDOW) window = COOP_MAX_WINDOW;
+    planner->map = map;
+    planner->profile = profile;
+    planner->window = window;
+    initSpaceTimeHash(&planner->reservations, 1024);
+    initSpaceTimeHash(&planner->nodeIndex, 2 * COOP_MAX_NODES);
+    planner->nodeTile = (int*)malloc(COOP_MAX_NODES * sizeof(int));
+    planner->nodeTime = (unsigned char*)malloc(COOP_MAX_NODES * sizeof(unsigned char));
+    planner->scratch = createPathScratchSized(COOP_MAX_NODES);
+}
+
+void UnloadCoopPlanner(CoopPlanner* planner) {
+    freeSpaceTimeHash(&planner->reservations);
+    freeSpaceTimeHash(&planner->nodeIndex);
+    free(planner->nodeTile);
+    free(planner->nodeTime);
+    DestroyPathScratch(&planner->scratch);
+    *planner = (CoopPlanner){ 0 };
+}
+
+void ClearCoopReservations(CoopPlanner* planner) {
+    clearSpaceTimeHash(&planner->reservations);
+}
+
+// Unit holding a tile at a time step of the current window, COOP_NO_UNIT if it is free
+int GetCoopReservation(const CoopPlanner* planner, int tileIndex, int time) {
+    int unit = findSpaceTime(&planner->reservations, spaceTimeKey(tileIndex, time));
+    return (unit >= 0) ? unit : COOP_NO_UNIT;
+}
+
+// Is the state taken by a unit other than this one?
+static inline bool isCoopReserved(const CoopPlanner* planner, int unit, int tileIndex, int time) {
+    int holder = GetCoopReservation(planner, tileIndex, time);
+    return holder != COOP_NO_UNIT && holder != unit;
+}
+
+// Can the unit move from tile to next between time and time + 1? The target state must be
+// free, and no other unit may be moving from next to tile at the same time.
+static bool isCoopMoveFree(const CoopPlanner* planner, int unit, int tileIndex, int nextIndex, int time) {
+    if (isCoopReserved(planner, unit, nextIndex, time + 1)) {
+        return false;
+    }
+    if (nextIndex == tileIndex) {
+        return true;
+    }
+    int oncoming = GetCoopReservation(planner, nextIndex, time);
+    return oncoming == COOP_NO_UNIT || oncoming == unit || GetCoopReservation(planner, tileIndex, time + 1) != oncoming;
+}
+
+// Search state of (tile, time), created if needed; -1 once COOP_MAX_NODES states exist
+static int coopNode(CoopPlanner* planner, int tileIndex, int time) {
+    unsigned int key = spaceTimeKey(tileIndex, time);
+    int node = findSpaceTime(&planner->nodeIndex, key);
+    if (node >= 0 || planner->nodeCount == COOP_MAX_NODES) {
+        return node;
+    }
+    node = planner->nodeCount++;
+    planner->nodeTile[node] = tileIndex;
+    planner->nodeTime[node] = (unsigned char)time;
+    insertSpaceTime(&planner->nodeIndex, key, node);
+    return node;
+}
+
+// Can a unit that arrives at its goal at this time stay there until the window ends?
+static bool isCoopGoalFree(const CoopPlanner* planner, int unit, int goalIndex, int time) {
+    for (int t = time + 1; t <= planner->window; t++) {
+        if (isCoopReserved(planner, unit, goalIndex, t)) return false;
+    }
+    return true;
+}
+
+static void relaxCoopMove(CoopPlanner* planner, const PathHeuristic* heuristic, int unit, int current, int nextIndex, int cost) {
+    int tileIndex = planner->nodeTile[current];
+    int time = planner->nodeTime[current];
+    if (!isCoopMoveFree(planner, unit, tileIndex, nextIndex, time)) {
+        return;
+    }
+    int node = coopNode(planner, nextIndex, time + 1);
+    if (node >= 0) {
+        relaxPathTile(&planner->scratch, node, planner->scratch.g[current] + cost, pathHeuristic(heuristic, planner->map->tiles[nextIndex].position), current);
+    }
+}
+
+// Plans the moves of a unit (id >= 0) from start towards goal for the planner's window and
+// reserves them. path receives the tile of the unit at every time step (path[0] is start;
+// waits repeat a tile) and must have room for window + 1 tiles. Returns the number of steps
+// written: if path[count - 1] is the goal the unit reached it and holds it until the window
+// ends; otherwise the plan is the best partial route (or waiting in place) and the unit
+// should plan again next turn. Returns 0 if start or goal is outside the map. Every move
+// costs the terrain (or overlay edge) cost of a normal path step, a wait the cheapest
+// terrain cost, and one time step.
+int PlanCoopPath(CoopPlanner* planner, int unit, Hex start, Hex goal, int* path) {
+    const Map* map = planner->map;
+    const PathProfile* profile = &planner->profile;
+    int startIndex = GetTileIndex(map, start);
+    int goalIndex = GetTileIndex(map, goal);
+    if (startIndex < 0 || goalIndex < 0) {
+        return 0;
+    }
+
+    PathScratch* scratch = &planner->scratch;
+    PathHeuristic heuristic = makePathHeuristic(map, profile, goalIndex);
+    int waitCost = (heuristic.stepCost > 0) ? heuristic.stepCost : 1;
+    bool goalEnterable = (startIndex == goalIndex || GetPathStepCost(map, profile, goalIndex) != PATH_COST_BLOCKED);
+
+    clearSpaceTimeHash(&planner->nodeIndex);
+    planner->nodeCount = 0;
+    planner->expanded = 0;
+    beginPathSearch(scratch);
+    int first = coopNode(planner, startIndex, 0);
+    relaxPathTile(scratch, first, 0, pathHeuristic(&heuristic, start), -1);
+
+    // The search ends on the goal. Without a way to reach it within the window, the plan
+    // ends on the first state popped at the window's end (lowest estimate), or if there is
+    // none, on the closest state seen
+    int end = -1;
+    int windowEnd = -1;
+    int closest = first;
+    while (scratch->heapSize > 0) {
+        int current = heapPop(scratch);
+        int tileIndex = planner->nodeTile[current];
+        int time = planner->nodeTime[current];
+        planner->expanded++;
+
+        if (goalEnterable && tileIndex == goalIndex && isCoopGoalFree(planner, unit, goalIndex, time)) {
+            end = current;
+            break;
+        }
+        if (time == planner->window) {
+            if (windowEnd < 0) windowEnd = current;
+            continue;
+        }
+        int h = scratch->f[current] - scratch->g[current];
+        int closestH = scratch->f[closest] - scratch->g[closest];
+        if (h < closestH || (h == closestH && time > planner->nodeTime[closest])) closest = current;
+
+        Hex hex = map->tiles[tileIndex].position;
+        for (int dir = 0; dir < 6; dir++) {
+            int neighbor = GetTileIndex(map, HexNeighbor(hex, dir));
+            if (neighbor < 0) continue;
+            int stepCost = GetPathStepCost(map, profile, neighbor);
+            if (stepCost != PATH_COST_BLOCKED) relaxCoopMove(planner, &heuristic, unit, current, neighbor, stepCost);
+        }
+        for (int e = FirstOverlayEdgeFrom(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextOut) {
+            const MapOverlayEdge* edge = &map->overlayEdges[e];
+            if (GetPathStepCost(map, profile, edge->to) != PATH_COST_BLOCKED) relaxCoopMove(planner, &heuristic, unit, current, edge->to, edge->cost);
+        }
+        relaxCoopMove(planner, &heuristic, unit, current, tileIndex, waitCost);
+    }
+    if (end < 0) end = (windowEnd >= 0) ? windowEnd : closest;
+
+    // Write and reserve the plan, then hold the last tile for the rest of the window while it is free
+    int count = planner->nodeTime[end] + 1;
+    for (int node = end; node >= 0; node = scratch->parent[node]) {
+        int time = planner->nodeTime[node];
+        path[time] = planner->nodeTile[node];
+        insertSpaceTime(&planner->reservations, spaceTimeKey(path[time], time), unit);
+    }
+    for (int t = count; t <= planner->window && !isCoopReserved(planner, unit, path[count - 1], t); t++) {
+        insertSpaceTime(&planner->reservations, spaceTimeKey(path[count - 1], t), unit);
+    }
+    return count;
+}
@@ -0,0 +1,439 @@
+/*
+    This is a utility file for entity storage: an entity-component system (ECS) for units,
+    fleets, planets and whatever else the game simulates.
+
+    An entity is an id with a set of components (plain structs registered with their size).
+    Entities with the same set of components share an archetype, which stores them as a
+    structure of arrays: one contiguous column per component plus the entity ids, row by row.
+    A system asks for the archetypes that have some components (and lack others) and gets one
+    view per archetype with the row count and a pointer to each column, so per-turn work
+    (upkeep, movement, combat) is a tight loop over contiguous arrays with no per-entity
+    lookups or pointer chasing.
+
+    Adding or removing a component moves the entity's row to another archetype (the target is
+    cached per archetype and component); removing a row moves the last row into the hole, so
+    columns stay dense. Such structural changes would invalidate the columns a system is
+    iterating, so while a system runs (or between BeginEcsDefer() and EndEcsDefer()) they are
+    queued, with their component values, and applied in order once it is done. Entities
+    created while deferred get their id immediately.
+
+    Entities are generational handles (utils_handles.c) to records in a HandlePool (archetype
+    and row per entity): holding an entity across changes is safe, a destroyed entity's handle
+    is detected as stale in O(1), and creating or destroying entities reuses pooled records
+    and archetype rows instead of allocating.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitEcsWorld: Creates an empty world.
+    - UnloadEcsWorld: Frees every archetype, record and queued change.
+    - RegisterEcsComponent: Registers a component type by size and returns its id.
+    - CreateEntity / DestroyEntity: Create an entity without components / destroy one.
+    - AddComponent / RemoveComponent: Change the components of an entity.
+    - GetComponent / HasComponent: Access a component of an entity.
+    - IsEntityAlive: Checks whether an entity handle refers to a live entity.
+    - GetEntityInSlot: Returns the live entity whose handle has some slot index.
+    - GetEntityCount: Returns the number of live entities.
+    - BeginEcsDefer / EndEcsDefer: Queue structural changes and apply them later.
+    - RunEcsSystem: Calls a system once per archetype matching a component query.
+    - GetEcsColumn: Returns the column of a component in a system view.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - Entity: Generational handle of an entity.
+    - EcsMask: Set of component ids (ECS_MASK() of one component).
+    - EcsArchetype: Rows of all entities with one set of components, one column per component.
+    - EcsRecord: Archetype and row of one entity.
+    - EcsCommand: Queued structural change.
+    - EcsView: Rows and columns of one archetype handed to a system.
+    - EcsSystem: Function processing one view.
+    - EcsWorld: Components, archetypes, entity records and the change queue.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ECS_MAX_COMPONENTS 64
+#define ECS_NO_ENTITY NULL_HANDLE       // Never a live entity
+#define ECS_MASK(component) ((EcsMask)1 << (component))
+
+#define ECS_PENDING -1                  // EcsRecord.archetype of entities created while deferred
+
+typedef Handle Entity;
+typedef uint64_t EcsMask;
+
+typedef struct EcsArchetype {
+    EcsMask mask;
+    Entity* entities;                   // Per row
+    unsigned char* columns[ECS_MAX_COMPONENTS]; // Per component of mask, NULL for others (and sizeless tags)
+    int count;
+    int capacity;
+    int addEdge[ECS_MAX_COMPONENTS];    // Archetype with one more component, -1 until needed
+    int removeEdge[ECS_MAX_COMPONENTS]; // Archetype with one component less, -1 until needed
+} EcsArchetype;
+
+typedef struct EcsRecord {
+    int archetype;                      // ECS_PENDING until the entity has a row
+    int row;
+} EcsRecord;
+
+typedef enum EcsCommandKind {
+    ECS_COMMAND_CREATE = 0,
+    ECS_COMMAND_DESTROY,
+    ECS_COMMAND_ADD,
+    ECS_COMMAND_REMOVE
+} EcsCommandKind;
+
+typedef struct EcsCommand {
+    EcsCommandKind kind;
+    Entity entity;
+    int component;
+    int dataOffset;                     // Component value in EcsWorld.commandData, -1 for none
+} EcsCommand;
+
+typedef struct EcsView {
+    int count;                          // Rows
+    const Entity* entities;             // Entity of each row
+    unsigned char* const* columns;      // Per component id, see GetEcsColumn()
+} EcsView;
+
+struct EcsWorld;
+
+// Processes the rows of one archetype matching a query
+typedef void (*EcsSystem)(struct EcsWorld* world, const EcsView* view, void* userData);
+
+typedef struct EcsWorld {
+    int componentCount;
+    int componentSize[ECS_MAX_COMPONENTS];
+
+    EcsArchetype* archetypes;           // Archetype 0 has no components
+    int archetypeCount;
+    int archetypeCapacity;
+
+    HandlePool records;                 // EcsRecord per entity
+
+    int deferDepth;                     // Structural changes are queued while > 0
+    EcsCommand* commands;
+    int commandCount;
+    int commandCapacity;
+    unsigned char* commandData;
+    int commandDataSize;
+    int commandDataCapacity;
+} EcsWorld;
+
+// Record of a live entity
+static inline EcsRecord* ecsRecord(const EcsWorld* world, Entity entity) {
+    return (EcsRecord*)world->records.items + GetHandleIndex(entity);
+}
+
+// Grows *buffer to hold needed elements of a size, doubling from an initial capacity
+static bool growEcsBuffer(void** buffer, int* capacity, int needed, int size, int initial) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    int newCapacity = (*capacity > 0) ? *capacity : initial;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* grown = realloc(*buffer, (size_t)newCapacity * size);
+    if (grown == NULL) {
+        return false;
+    }
+    *buffer = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+// Archetype with a set of components, created if needed; -1 if it could not be
+static int findEcsArchetype(EcsWorld* world, EcsMask mask) {
+    for (int a = 0; a < world->archetypeCount; a++) {
+        if (world->archetypes[a].mask == mask) return a;
+    }
+    if (!growEcsBuffer((void**)&world->archetypes, &world->archetypeCapacity, world->archetypeCount + 1, sizeof(EcsArchetype), 16)) {
+        return -1;
+    }
+    EcsArchetype* archetype = &world->archetypes[world->archetypeCount];
+    *archetype = (EcsArchetype){ 0 };
+    archetype->mask = mask;
+    for (int c = 0; c < ECS_MAX_COMPONENTS; c++) {
+        archetype->addEdge[c] = -1;
+        archetype->removeEdge[c] = -1;
+    }
+    return world->archetypeCount++;
+}
+
+// Archetype reached from another by adding or removing one component
+static int nextEcsArchetype(EcsWorld* world, int from, int component, bool add) {
+    int* edge = add ? &world->archetypes[from].addEdge[component] : &world->archetypes[from].removeEdge[component];
+    if (*edge < 0) {
+        EcsMask mask = world->archetypes[from].mask;
+        int to = findEcsArchetype(world, add ? (mask | ECS_MASK(component)) : (mask & ~ECS_MASK(component)));
+        // The archetype array may have moved
+        edge = add ? &world->archetypes[from].addEdge[component] : &world->archetypes[from].removeEdge[component];
+        *edge = to;
+    }
+    return *edge;
+}
+
+// Appends an uninitialized row for an entity; -1 if the columns could not grow
+static int addEcsRow(EcsWorld* world, int a, Entity entity) {
+    EcsArchetype* archetype = &world->archetypes[a];
+    if (archetype->count == archetype->capacity) {
+        int capacity = (archetype->capacity > 0) ? 2 * archetype->capacity : 64;
+        Entity* entities = (Entity*)realloc(archetype->entities, capacity * sizeof(Entity));
+        if (entities == NULL) {
+            return -1;
+        }
+        archetype->entities = entities;
+        for (int c = 0; c < world->componentCount; c++) {
+            if (!(archetype->mask & ECS_MASK(c)) || world->componentSize[c] == 0) continue;
+            unsigned char* column = (unsigned char*)realloc(archetype->columns[c], (size_t)capacity * world->componentSize[c]);
+            if (column == NULL) {
+                return -1;
+            }
+            archetype->columns[c] = column;
+        }
+        archetype->capacity = capacity;
+    }
+    int row = archetype->count++;
+    archetype->entities[row] = entity;
+    *ecsRecord(world, entity) = (EcsRecord){ a, row };
+    return row;
+}
+
+// Removes a row by moving the last row into it
+static void removeEcsRow(EcsWorld* world, int a, int row) {
+    EcsArchetype* archetype = &world->archetypes[a];
+    int last = --archetype->count;
+    if (row == last) {
+        return;
+    }
+    for (int c = 0; c < world->componentCount; c++) {
+        if (archetype->columns[c] == NULL) continue;
+        int size = world->componentSize[c];
+        memcpy(archetype->columns[c] + (size_t)row * size, archetype->columns[c] + (size_t)last * size, size);
+    }
+    Entity moved = archetype->entities[last];
+    archetype->entities[row] = moved;
+    ecsRecord(world, moved)->row = row;
+}
+
+// Moves an entity's row to another archetype, keeping the components both have. Returns the
+// new row, -1 if it could not be added.
+static int moveEcsEntity(EcsWorld* world, Entity entity, int to) {
+    EcsRecord from = *ecsRecord(world, entity);
+    int row = addEcsRow(world, to, entity);
+    if (row < 0) {
+        return -1;
+    }
+    const EcsArchetype* source = &world->archetypes[from.archetype];
+    EcsArchetype* target = &world->archetypes[to];
+    for (int c = 0; c < world->componentCount; c++) {
+        if (source->columns[c] == NULL || target->columns[c] == NULL) continue;
+        int size = world->componentSize[c];
+        memcpy(target->columns[c] + (size_t)row * size, source->columns[c] + (size_t)from.row * size, size);
+    }
+    removeEcsRow(world, from.archetype, from.row);
+    return row;
+}
+
+// Queues a structural change; value (component size bytes) is copied. False if out of memory.
+static bool queueEcsCommand(EcsWorld* world, EcsCommandKind kind, Entity entity, int component, const void* value) {
+    if (!growEcsBuffer((void**)&world->commands, &world->commandCapacity, world->commandCount + 1, sizeof(EcsCommand), 256)) {
+        return false;
+    }
+    int dataOffset = -1;
+    if (value != NULL) {
+        int size = world->componentSize[component];
+        if (!growEcsBuffer((void**)&world->commandData, &world->commandDataCapacity, world->commandDataSize + size, 1, 4096)) {
+            return false;
+        }
+        dataOffset = world->commandDataSize;
+        memcpy(world->commandData + dataOffset, value, size);
+        world->commandDataSize += size;
+    }
+    world->commands[world->commandCount++] = (EcsCommand){ kind, entity, component, dataOffset };
+    return true;
+}
+
+void InitEcsWorld(EcsWorld* world) {
+    *world = (EcsWorld){ 0 };
+    InitHandlePool(&world->records, sizeof(EcsRecord), 1024);
+    findEcsArchetype(world, 0);
+}
+
+void UnloadEcsWorld(EcsWorld* world) {
+    for (int a = 0; a < world->archetypeCount; a++) {
+        free(world->archetypes[a].entities);
+        for (int c = 0; c < ECS_MAX_COMPONENTS; c++) free(world->archetypes[a].columns[c]);
+    }
+    free(world->archetypes);
+    UnloadHandlePool(&world->records);
+    free(world->commands);
+    free(world->commandData);
+    *world = (EcsWorld){ 0 };
+}
+
+// Registers a component type of size bytes (0 for a tag without data). Returns its id, or
+// -1 once ECS_MAX_COMPONENTS are registered.
+int RegisterEcsComponent(EcsWorld* world, int size) {
+    if (world->componentCount == ECS_MAX_COMPONENTS) {
+        return -1;
+    }
+    world->componentSize[world->componentCount] = (size > 0) ? size : 0;
+    return world->componentCount++;
+}
+
+bool IsEntityAlive(const EcsWorld* world, Entity entity) {
+    return IsHandleValid(&world->records, entity);
+}
+
+// Entity of a handle slot (see GetHandleIndex()), ECS_NO_ENTITY if none lives there
+Entity GetEntityInSlot(const EcsWorld* world, int slot) {
+    return GetHandleAt(&world->records, slot);
+}
+
+int GetEntityCount(const EcsWorld* world) {
+    return world->records.count;
+}
+
+// Creates an entity without components; ECS_NO_ENTITY if out of memory
+Entity CreateEntity(EcsWorld* world) {
+    Entity entity = AllocHandle(&world->records);
+    if (entity == NULL_HANDLE) {
+        return ECS_NO_ENTITY;
+    }
+    *ecsRecord(world, entity) = (EcsRecord){ ECS_PENDING, -1 };
+
+    bool added = (world->deferDepth > 0) ? queueEcsCommand(world, ECS_COMMAND_CREATE, entity, 0, NULL) : (addEcsRow(world, 0, entity) >= 0);
+    if (!added) {
+        FreeHandle(&world->records, entity);
+        return ECS_NO_ENTITY;
+    }
+    return entity;
+}
+
+void DestroyEntity(EcsWorld* world, Entity entity) {
+    if (!IsEntityAlive(world, entity)) {
+        return;
+    }
+    if (world->deferDepth > 0) {
+        queueEcsCommand(world, ECS_COMMAND_DESTROY, entity, 0, NULL);
+        return;
+    }
+    EcsRecord record = *ecsRecord(world, entity);
+    if (record.archetype >= 0) removeEcsRow(world, record.archetype, record.row);
+    FreeHandle(&world->records, entity);
+}
+
+// Adds a component (or overwrites it if the entity has it) with a value, zeroed if value is
+// NULL. Returns false if the entity is not alive or memory ran out.
+bool AddComponent(EcsWorld* world, Entity entity, int component, const void* value) {
+    if (!IsEntityAlive(world, entity) || component < 0 || component >= world->componentCount) {
+        return false;
+    }
+    if (world->deferDepth > 0) {
+        return queueEcsCommand(world, ECS_COMMAND_ADD, entity, component, value);
+    }
+
+    EcsRecord record = *ecsRecord(world, entity);
+    int row = record.row;
+    int a = record.archetype;
+    if (!(world->archetypes[a].mask & ECS_MASK(component))) {
+        a = nextEcsArchetype(world, a, component, true);
+        if (a < 0 || (row = moveEcsEntity(world, entity, a)) < 0) {
+            return false;
+        }
+    }
+    int size = world->componentSize[component];
+    if (size > 0) {
+        unsigned char* target = world->archetypes[a].columns[component] + (size_t)row * size;
+        if (value != NULL) memcpy(target, value, size);
+        else memset(target, 0, size);
+    }
+    return true;
+}
+
+bool RemoveComponent(EcsWorld* world, Entity entity, int component) {
+    if (!IsEntityAlive(world, entity) || component < 0 || component >= world->componentCount) {
+        return false;
+    }
+    if (world->deferDepth > 0) {
+        return queueEcsCommand(world, ECS_COMMAND_REMOVE, entity, component, NULL);
+    }
+
+    int a = ecsRecord(world, entity)->archetype;
+    if (!(world->archetypes[a].mask & ECS_MASK(component))) {
+        return true;
+    }
+    a = nextEcsArchetype(world, a, component, false);
+    return a >= 0 && moveEcsEntity(world, entity, a) >= 0;
+}
+
+bool HasComponent(const EcsWorld* world, Entity entity, int component) {
+    if (!IsEntityAlive(world, entity) || ecsRecord(world, entity)->archetype < 0) {
+        return false;
+    }
+    return (world->archetypes[ecsRecord(world, entity)->archetype].mask & ECS_MASK(component)) != 0;
+}
+
+// Component of an entity, NULL if it has none (or its addition is still queued). The pointer
+// is valid until the next structural change.
+void* GetComponent(const EcsWorld* world, Entity entity, int component) {
+    if (!HasComponent(world, entity, component)) {
+        return NULL;
+    }
+    const EcsRecord* record = ecsRecord(world, entity);
+    unsigned char* column = world->archetypes[record->archetype].columns[component];
+    return (column != NULL) ? column + (size_t)record->row * world->componentSize[component] : NULL;
+}
+
+void BeginEcsDefer(EcsWorld* world) {
+    world->deferDepth++;
+}
+
+// Applies the queued changes, in order, once the outermost deferral ends
+void EndEcsDefer(EcsWorld* world) {
+    if (world->deferDepth == 0 || --world->deferDepth > 0) {
+        return;
+    }
+    for (int k = 0; k < world->commandCount; k++) {
+        const EcsCommand* command = &world->commands[k];
+        const void* value = (command->dataOffset >= 0) ? world->commandData + command->dataOffset : NULL;
+        if (!IsEntityAlive(world, command->entity)) continue;
+        switch (command->kind) {
+            case ECS_COMMAND_CREATE:
+                if (addEcsRow(world, 0, command->entity) < 0) {
+                    FreeHandle(&world->records, command->entity);
+                }
+                break;
+            case ECS_COMMAND_DESTROY: DestroyEntity(world, command->entity); break;
+            case ECS_COMMAND_ADD:     AddComponent(world, command->entity, command->component, value); break;
+            case ECS_COMMAND_REMOVE:  RemoveComponent(world, command->entity, command->component); break;
+        }
+    }
+    world->commandCount = 0;
+    world->commandDataSize = 0;
+}
+
+// Column of a component in a view: the component of row i is at index i. NULL if the view's
+// archetype does not have the component (or it is a tag).
+void* GetEcsColumn(const EcsView* view, int component) {
+    return view->columns[component];
+}
+
+// Calls system once per non-empty archetype that has every component of all and none of
+// none. Structural changes made meanwhile are deferred until all views are done. Returns the
+// number of entities visited.
+int RunEcsSystem(EcsWorld* world, EcsMask all, EcsMask none, EcsSystem system, void* userData) {
+    int visited = 0;
+    BeginEcsDefer(world);
+    for (int a = 0; a < world->archetypeCount; a++) {
+        const EcsArchetype* archetype = &world->archetypes[a];
+        if ((archetype->mask & all) != all || (archetype->mask & none) != 0 || archetype->count == 0) continue;
+        EcsView view = { archetype->count, archetype->entities, archetype->columns };
+        system(world, &view, userData);
+        visited += view.count;
+    }
+    EndEcsDefer(world);
+    return visited;
+}
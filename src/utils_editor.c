@@ -0,0 +1,195 @@
+/*
+    This is a utility file for painting terrain on a hex map (scenario editor).
+
+    A stroke collects the tiles touched by a tool while the mouse button is held and applies
+    them with a single SetTileTypes() call when the stroke ends, so a stroke costs one index
+    pass, one walkability update and one change notification no matter how many tiles it covers.
+    Tiles are deduplicated with a per-tile stroke stamp, so dragging over the same area does not
+    grow the stroke. Applied strokes are recorded in an optional UndoHistory; brush strokes that
+    follow each other quickly are merged into one undo step.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - CreateMapEditor: Creates an editor with stroke buffers sized for a map.
+    - DestroyMapEditor: Frees the memory allocated for the editor.
+    - BeginEditorStroke: Starts a stroke at a hex with the current tool.
+    - ContinueEditorStroke: Extends the current stroke to a hex.
+    - EndEditorStroke: Finishes the stroke and applies it to the map.
+    - CancelEditorStroke: Drops the current stroke without changing the map.
+    - IsTileInStroke: Checks whether a tile index is part of the current stroke.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - EditorTool: Painting tools (brush, line, fill).
+    - MapEditor: Editor settings plus the pending stroke.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+#define EDITOR_MAX_BRUSH_RADIUS 16
+#define EDITOR_MAX_LINE_HEXES 1024  // Line hexes kept on the stack (longer lines are allocated)
+#define EDITOR_STROKE_MERGE_SECONDS 0.5 // Brush strokes this close together undo as one step
+
+typedef enum EditorTool {
+    EDITOR_TOOL_BRUSH = 0,  // Paint every tile within brushRadius of the cursor
+    EDITOR_TOOL_LINE,       // Paint a straight line (brushRadius thick) from press to release
+    EDITOR_TOOL_FILL        // Paint the connected area of same-type tiles under the cursor
+} EditorTool;
+
+typedef struct MapEditor {
+    bool enabled;           // Is the editor mode active?
+    EditorTool tool;        // Current tool
+    TileType paintType;     // Terrain applied by the tools
+    int brushRadius;        // Brush radius in hexes (0 paints a single tile)
+
+    bool stroking;          // Is a stroke in progress?
+    Hex strokeStart;        // Hex where the stroke began
+    Hex strokeLast;         // Last hex the stroke was extended to
+    int* strokeIndices;     // Tiles touched by the stroke (unique)
+    int strokeCount;
+    unsigned int* strokeStamp;  // Per tile: id of the last stroke that touched it
+    unsigned int strokeId;
+    FloodFill fill;         // Scanline fill state for the fill tool
+
+    UndoHistory* history;   // Where applied strokes are recorded (NULL: no undo)
+    double lastStrokeEnd;   // Time the last stroke was applied
+    int tileCount;          // Size of the per-tile buffers
+} MapEditor;
+
+MapEditor CreateMapEditor(const Map* map) {
+    MapEditor editor = { 0 };
+    editor.tool = EDITOR_TOOL_BRUSH;
+    editor.paintType = TILE_GRASS;
+    editor.brushRadius = 1;
+    editor.tileCount = map->tileCount;
+    editor.strokeIndices = (int*)malloc(map->tileCount * sizeof(int));
+    editor.strokeStamp = (unsigned int*)calloc(map->tileCount, sizeof(unsigned int));
+    editor.fill = CreateFloodFill(map);
+    return editor;
+}
+
+void DestroyMapEditor(MapEditor* editor) {
+    free(editor->strokeIndices);
+    free(editor->strokeStamp);
+    DestroyFloodFill(&editor->fill);
+    editor->strokeIndices = NULL;
+    editor->strokeStamp = NULL;
+    editor->tileCount = 0;
+}
+
+bool IsTileInStroke(const MapEditor* editor, int tileIndex) {
+    return editor->stroking && editor->strokeStamp[tileIndex] == editor->strokeId;
+}
+
+static void strokeAdd(MapEditor* editor, int tileIndex) {
+    if (editor->strokeStamp[tileIndex] != editor->strokeId) {
+        editor->strokeStamp[tileIndex] = editor->strokeId;
+        editor->strokeIndices[editor->strokeCount++] = tileIndex;
+    }
+}
+
+// Adds every map tile within the brush radius; each map row of the disc is a contiguous index run
+static void strokeAddDisc(MapEditor* editor, const Map* map, Hex center) {
+    int n = editor->brushRadius;
+    for (int dr = -n; dr <= n; dr++) {
+        int firstIndex, qMin, qMax;
+        if (!GetMapRow(map, center.r + dr, &firstIndex, &qMin, &qMax)) continue;
+
+        int qFrom = center.q + ((-n > -dr - n) ? -n : -dr - n);
+        int qTo = center.q + ((n < -dr + n) ? n : -dr + n);
+        if (qFrom < qMin) qFrom = qMin;
+        if (qTo > qMax) qTo = qMax;
+        for (int q = qFrom; q <= qTo; q++) {
+            strokeAdd(editor, firstIndex + (q - qMin));
+        }
+    }
+}
+
+static void strokeAddLine(MapEditor* editor, const Map* map, Hex from, Hex to) {
+    // Longer lines get a heap buffer, so the line is never cut short
+    Hex stackLine[EDITOR_MAX_LINE_HEXES];
+    Hex* line = stackLine;
+    int length = HexDistance(from, to) + 1;
+    if (length > EDITOR_MAX_LINE_HEXES) {
+        line = (Hex*)malloc(length * sizeof(Hex));
+        if (line == NULL) {
+            TraceLog(LOG_WARNING, "Editor line of %d hexes dropped: out of memory", length);
+            return;
+        }
+    }
+
+    int count = HexLineDraw(from, to, line, length);
+    for (int i = 0; i < count; i++) {
+        strokeAddDisc(editor, map, line[i]);
+    }
+    if (line != stackLine) free(line);
+}
+
+// Connected area of the start tile's terrain; fills only ever start a fresh stroke. A fill
+// that ran out of memory paints nothing rather than part of the area.
+static void strokeAddFill(MapEditor* editor, const Map* map, Hex start) {
+    int count = FloodFillRegion(&editor->fill, map, start, REGION_SAME_TYPE, NULL, NULL, editor->strokeIndices, editor->tileCount);
+    editor->strokeCount = (count > 0) ? count : 0;
+    for (int i = 0; i < editor->strokeCount; i++) {
+        editor->strokeStamp[editor->strokeIndices[i]] = editor->strokeId;
+    }
+}
+
+// Starts an empty stroke buffer with a fresh stamp
+static void resetStroke(MapEditor* editor) {
+    editor->strokeId++;
+    if (editor->strokeId == 0) {
+        // Stamp counter wrapped: old stamps could collide with new stroke ids
+        for (int i = 0; i < editor->tileCount; i++) editor->strokeStamp[i] = 0;
+        editor->strokeId = 1;
+    }
+    editor->strokeCount = 0;
+}
+
+void BeginEditorStroke(MapEditor* editor, const Map* map, Hex hex) {
+    resetStroke(editor);
+    editor->stroking = true;
+    editor->strokeStart = hex;
+    editor->strokeLast = hex;
+
+    switch (editor->tool) {
+        case EDITOR_TOOL_BRUSH: strokeAddDisc(editor, map, hex); break;
+        case EDITOR_TOOL_LINE:  strokeAddDisc(editor, map, hex); break;
+        case EDITOR_TOOL_FILL:  strokeAddFill(editor, map, hex); break;
+        default: break;
+    }
+}
+
+void ContinueEditorStroke(MapEditor* editor, const Map* map, Hex hex) {
+    if (!editor->stroking || HexEquals(hex, editor->strokeLast)) return;
+
+    if (editor->tool == EDITOR_TOOL_BRUSH) {
+        // Cover the whole segment so fast mouse moves leave no gaps
+        strokeAddLine(editor, map, editor->strokeLast, hex);
+    }
+    else if (editor->tool == EDITOR_TOOL_LINE) {
+        // The preview follows the cursor: rebuild the line from the start hex
+        resetStroke(editor);
+        strokeAddLine(editor, map, editor->strokeStart, hex);
+    }
+    editor->strokeLast = hex;
+}
+
+// Returns the number of tiles whose terrain changed; time is the release time in seconds
+int EndEditorStroke(MapEditor* editor, Map* map, double time) {
+    if (!editor->stroking) return 0;
+    editor->stroking = false;
+
+    if (editor->history != NULL) {
+        bool merge = (editor->tool == EDITOR_TOOL_BRUSH) && (time - editor->lastStrokeEnd <= EDITOR_STROKE_MERGE_SECONDS);
+        RecordTileTypes(editor->history, map, editor->strokeIndices, editor->strokeCount, editor->paintType, merge);
+    }
+    editor->lastStrokeEnd = time;
+    return SetTileTypes(map, editor->strokeIndices, editor->strokeCount, editor->paintType);
+}
+
+void CancelEditorStroke(MapEditor* editor) {
+    editor->stroking = false;
+    editor->strokeCount = 0;
+}
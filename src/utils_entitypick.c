@@ -0,0 +1,317 @@
+/*
+    This is a utility file for picking entities (fleets, planets, ...) under the mouse.
+
+    Entities register their world-space bounds with an EntityPickGrid. The grid converts them to
+    screen space with the current camera and files them into fixed-size screen buckets, so a
+    click or a selection box only looks at the entities in the buckets it overlaps instead of
+    scanning every entity. Moving an entity only re-files that entity (and only if it changed
+    buckets); a camera change re-files everything once, lazily, before the next query.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - CreateEntityPickGrid: Creates an empty grid covering the game screen.
+    - DestroyEntityPickGrid: Frees the memory allocated for the grid.
+    - SetPickGridCamera: Sets the camera used to map world bounds to the screen.
+    - InvalidatePickGrid: Defers all re-filing to the next query (for bulk moves).
+    - UpdatePickEntity: Inserts an entity or updates its world bounds.
+    - RemovePickEntity: Removes an entity from the grid.
+    - PickEntityAt: Returns the entity under a screen point.
+    - QueryEntitiesInRect: Collects the entities overlapping a screen rectangle.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - PickBucket: Entry indices filed in one screen cell.
+    - PickEntry: Registered entity with its world and screen bounds.
+    - EntityPickGrid: Screen-space bucket grid plus entity entries.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+#define PICK_NO_ENTITY 0xFFFFFFFFu  // Returned when no entity is under the query
+
+typedef struct PickBucket {
+    int* entries;           // Indices into EntityPickGrid.entries
+    int count;
+    int capacity;
+} PickBucket;
+
+typedef struct PickEntry {
+    unsigned int id;        // Caller's entity id
+    Rectangle worldBounds;  // Bounds in world space
+    Rectangle screenBounds; // Bounds in screen space for the grid's camera
+    int cellX0, cellY0;     // Covered bucket range (inclusive), cellX0 > cellX1 when off-screen
+    int cellX1, cellY1;
+    unsigned int queryStamp;// Last query that reported this entry (deduplicates buckets)
+} PickEntry;
+
+typedef struct EntityPickGrid {
+    int cellSize;           // Bucket size in screen pixels
+    int columns;            // Buckets per row
+    int rows;               // Bucket rows
+    PickBucket* buckets;    // columns * rows buckets
+    PickEntry* entries;     // Dense array of registered entities
+    int entryCount;
+    int entryCapacity;
+    int* entryOfId;         // Entry index per entity id (-1 when not registered)
+    int idCapacity;
+    Camera2D camera;        // Camera the screen bounds were computed with
+    bool cameraDirty;       // Screen bounds must be recomputed before the next query (camera or bulk change)
+    unsigned int queryStamp;
+} EntityPickGrid;
+
+EntityPickGrid CreateEntityPickGrid(int screenWidth, int screenHeight, int cellSize) {
+    EntityPickGrid grid = { 0 };
+    grid.cellSize = cellSize;
+    grid.columns = (screenWidth + cellSize - 1) / cellSize;
+    grid.rows = (screenHeight + cellSize - 1) / cellSize;
+    grid.buckets = (PickBucket*)calloc(grid.columns * grid.rows, sizeof(PickBucket));
+    grid.camera.zoom = 1.0f;
+    return grid;
+}
+
+void DestroyEntityPickGrid(EntityPickGrid* grid) {
+    if (grid->buckets != NULL) {
+        for (int i = 0; i < grid->columns * grid->rows; i++) {
+            free(grid->buckets[i].entries);
+        }
+        free(grid->buckets);
+        grid->buckets = NULL;
+    }
+    free(grid->entries);
+    free(grid->entryOfId);
+    grid->entries = NULL;
+    grid->entryOfId = NULL;
+    grid->entryCount = 0;
+    grid->entryCapacity = 0;
+    grid->idCapacity = 0;
+}
+
+static void bucketAdd(PickBucket* bucket, int entry) {
+    if (bucket->count == bucket->capacity) {
+        int capacity = (bucket->capacity > 0) ? bucket->capacity * 2 : 4;
+        int* entries = (int*)realloc(bucket->entries, capacity * sizeof(int));
+        if (entries == NULL) {
+            TraceLog(LOG_ERROR, "Failed to grow entity pick bucket");
+            return;
+        }
+        bucket->entries = entries;
+        bucket->capacity = capacity;
+    }
+    bucket->entries[bucket->count++] = entry;
+}
+
+static void bucketReplace(PickBucket* bucket, int entry, int replacement) {
+    for (int i = 0; i < bucket->count; i++) {
+        if (bucket->entries[i] == entry) {
+            if (replacement >= 0) {
+                bucket->entries[i] = replacement;
+            }
+            else {
+                bucket->entries[i] = bucket->entries[--bucket->count];
+            }
+            return;
+        }
+    }
+}
+
+static void fileEntry(EntityPickGrid* grid, int index, bool add) {
+    PickEntry* entry = &grid->entries[index];
+    for (int y = entry->cellY0; y <= entry->cellY1; y++) {
+        for (int x = entry->cellX0; x <= entry->cellX1; x++) {
+            PickBucket* bucket = &grid->buckets[y * grid->columns + x];
+            if (add) bucketAdd(bucket, index);
+            else bucketReplace(bucket, index, -1);
+        }
+    }
+}
+
+// Screen bounds and covered bucket range for the grid's current camera
+static void placeEntry(const EntityPickGrid* grid, PickEntry* entry) {
+    Rectangle w = entry->worldBounds;
+    Vector2 a = GetWorldToScreen2D((Vector2){ w.x, w.y }, grid->camera);
+    Vector2 b = GetWorldToScreen2D((Vector2){ w.x + w.width, w.y + w.height }, grid->camera);
+    float x0 = fminf(a.x, b.x), y0 = fminf(a.y, b.y);
+    float x1 = fmaxf(a.x, b.x), y1 = fmaxf(a.y, b.y);
+    entry->screenBounds = (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+
+    int cx0 = (int)floorf(x0 / grid->cellSize), cy0 = (int)floorf(y0 / grid->cellSize);
+    int cx1 = (int)floorf(x1 / grid->cellSize), cy1 = (int)floorf(y1 / grid->cellSize);
+    entry->cellX0 = (cx0 < 0) ? 0 : cx0;
+    entry->cellY0 = (cy0 < 0) ? 0 : cy0;
+    entry->cellX1 = (cx1 >= grid->columns) ? grid->columns - 1 : cx1;
+    entry->cellY1 = (cy1 >= grid->rows) ? grid->rows - 1 : cy1;
+}
+
+static void refreshCamera(EntityPickGrid* grid) {
+    if (!grid->cameraDirty) {
+        return;
+    }
+    for (int i = 0; i < grid->columns * grid->rows; i++) {
+        grid->buckets[i].count = 0;
+    }
+    for (int i = 0; i < grid->entryCount; i++) {
+        placeEntry(grid, &grid->entries[i]);
+        fileEntry(grid, i, true);
+    }
+    grid->cameraDirty = false;
+}
+
+void SetPickGridCamera(EntityPickGrid* grid, Camera2D camera) {
+    if (camera.offset.x != grid->camera.offset.x || camera.offset.y != grid->camera.offset.y ||
+        camera.target.x != grid->camera.target.x || camera.target.y != grid->camera.target.y ||
+        camera.rotation != grid->camera.rotation || camera.zoom != grid->camera.zoom) {
+        grid->camera = camera;
+        grid->cameraDirty = true;
+    }
+}
+
+// Re-files every entity once before the next query, as after a camera change. Cheaper than
+// re-filing entity by entity when most of them are about to move.
+void InvalidatePickGrid(EntityPickGrid* grid) {
+    grid->cameraDirty = true;
+}
+
+void UpdatePickEntity(EntityPickGrid* grid, unsigned int id, Rectangle worldBounds) {
+    if ((int)id >= grid->idCapacity) {
+        int capacity = (grid->idCapacity > 0) ? grid->idCapacity : 64;
+        while (capacity <= (int)id) capacity *= 2;
+        int* entryOfId = (int*)realloc(grid->entryOfId, capacity * sizeof(int));
+        if (entryOfId == NULL) {
+            TraceLog(LOG_ERROR, "Failed to grow entity pick id table");
+            return;
+        }
+        for (int i = grid->idCapacity; i < capacity; i++) entryOfId[i] = -1;
+        grid->entryOfId = entryOfId;
+        grid->idCapacity = capacity;
+    }
+
+    int index = grid->entryOfId[id];
+    if (index < 0) {
+        if (grid->entryCount == grid->entryCapacity) {
+            int capacity = (grid->entryCapacity > 0) ? grid->entryCapacity * 2 : 64;
+            PickEntry* entries = (PickEntry*)realloc(grid->entries, capacity * sizeof(PickEntry));
+            if (entries == NULL) {
+                TraceLog(LOG_ERROR, "Failed to grow entity pick entries");
+                return;
+            }
+            grid->entries = entries;
+            grid->entryCapacity = capacity;
+        }
+        index = grid->entryCount++;
+        grid->entryOfId[id] = index;
+        grid->entries[index].id = id;
+        grid->entries[index].queryStamp = 0;
+        grid->entries[index].worldBounds = worldBounds;
+        if (!grid->cameraDirty) {
+            placeEntry(grid, &grid->entries[index]);
+            fileEntry(grid, index, true);
+        }
+        return;
+    }
+
+    PickEntry* entry = &grid->entries[index];
+    entry->worldBounds = worldBounds;
+    if (grid->cameraDirty) {
+        return;  // Everything is re-filed before the next query anyway
+    }
+
+    PickEntry moved = *entry;
+    placeEntry(grid, &moved);
+    if (moved.cellX0 != entry->cellX0 || moved.cellY0 != entry->cellY0 ||
+        moved.cellX1 != entry->cellX1 || moved.cellY1 != entry->cellY1) {
+        fileEntry(grid, index, false);
+        *entry = moved;
+        fileEntry(grid, index, true);
+    }
+    else {
+        entry->screenBounds = moved.screenBounds;
+    }
+}
+
+void RemovePickEntity(EntityPickGrid* grid, unsigned int id) {
+    if ((int)id >= grid->idCapacity || grid->entryOfId[id] < 0) {
+        return;
+    }
+
+    int index = grid->entryOfId[id];
+    int last = grid->entryCount - 1;
+    if (!grid->cameraDirty) {
+        fileEntry(grid, index, false);
+    }
+
+    // Keep entries dense: the last entry takes the removed one's slot
+    if (index != last) {
+        if (!grid->cameraDirty) {
+            PickEntry* moved = &grid->entries[last];
+            for (int y = moved->cellY0; y <= moved->cellY1; y++) {
+                for (int x = moved->cellX0; x <= moved->cellX1; x++) {
+                    bucketReplace(&grid->buckets[y * grid->columns + x], last, index);
+                }
+            }
+        }
+        grid->entries[index] = grid->entries[last];
+        grid->entryOfId[grid->entries[index].id] = index;
+    }
+    grid->entryOfId[id] = -1;
+    grid->entryCount--;
+}
+
+// Among overlapping entities the one whose center is closest to the point wins
+unsigned int PickEntityAt(EntityPickGrid* grid, Vector2 screenPoint) {
+    refreshCamera(grid);
+
+    int cx = (int)floorf(screenPoint.x / grid->cellSize);
+    int cy = (int)floorf(screenPoint.y / grid->cellSize);
+    if (cx < 0 || cy < 0 || cx >= grid->columns || cy >= grid->rows) {
+        return PICK_NO_ENTITY;
+    }
+
+    const PickBucket* bucket = &grid->buckets[cy * grid->columns + cx];
+    unsigned int best = PICK_NO_ENTITY;
+    float bestDistance = INFINITY;
+    for (int i = 0; i < bucket->count; i++) {
+        const PickEntry* entry = &grid->entries[bucket->entries[i]];
+        if (!CheckCollisionPointRec(screenPoint, entry->screenBounds)) continue;
+
+        Vector2 center = { entry->screenBounds.x + entry->screenBounds.width * 0.5f,
+                           entry->screenBounds.y + entry->screenBounds.height * 0.5f };
+        float distance = Vector2DistanceSqr(center, screenPoint);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = entry->id;
+        }
+    }
+    return best;
+}
+
+// Returns the number of ids written (at most maxIds)
+int QueryEntitiesInRect(EntityPickGrid* grid, Rectangle screenRect, unsigned int* ids, int maxIds) {
+    refreshCamera(grid);
+
+    int cx0 = (int)floorf(screenRect.x / grid->cellSize);
+    int cy0 = (int)floorf(screenRect.y / grid->cellSize);
+    int cx1 = (int)floorf((screenRect.x + screenRect.width) / grid->cellSize);
+    int cy1 = (int)floorf((screenRect.y + screenRect.height) / grid->cellSize);
+    if (cx0 < 0) cx0 = 0;
+    if (cy0 < 0) cy0 = 0;
+    if (cx1 >= grid->columns) cx1 = grid->columns - 1;
+    if (cy1 >= grid->rows) cy1 = grid->rows - 1;
+
+    grid->queryStamp++;
+    int found = 0;
+    for (int y = cy0; y <= cy1; y++) {
+        for (int x = cx0; x <= cx1; x++) {
+            const PickBucket* bucket = &grid->buckets[y * grid->columns + x];
+            for (int i = 0; i < bucket->count && found < maxIds; i++) {
+                PickEntry* entry = &grid->entries[bucket->entries[i]];
+                if (entry->queryStamp == grid->queryStamp) continue;
+                entry->queryStamp = grid->queryStamp;
+                if (CheckCollisionRecs(screenRect, entry->screenBounds)) {
+                    ids[found++] = entry->id;
+                }
+            }
+        }
+    }
+    return found;
+}
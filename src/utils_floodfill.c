@@ -0,0 +1,226 @@
+/*
+    This is a utility file for filling and querying connected regions of a hex map.
+
+    The fill works on whole map rows instead of single tiles (scanline flood fill). A seed tile
+    is widened left and right along its row as far as the region goes, the resulting span is
+    marked in a visited bitset with whole-word writes, and the rows above and below are scanned
+    only over the q range the span touches: one seed is pushed per run of matching tiles found
+    there. Because rows are contiguous in the tile array, the inner loops are plain index walks
+    and the seed stack stays proportional to the region's outline, not its area.
+
+    In axial coordinates a span [qL, qR] of row r touches [qL, qR + 1] of row r - 1 and
+    [qL - 1, qR] of row r + 1.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - CreateFloodFill: Allocates the visited bitset and seed stack for a map.
+    - DestroyFloodFill: Frees the memory allocated for the fill.
+    - FloodFillRegion: Fills the region connected to a start tile that matches a predicate.
+    - IsTileInRegion: Checks whether a tile index belongs to the last filled region.
+    - NextRegionTile: Iterates the tile indices of the last filled region in ascending order.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - RegionMatch: Built-in region predicates (same terrain, same owner, walkable) or custom.
+    - RegionPredicate: Custom per-tile predicate.
+    - FloodFill: Reusable fill state (visited bitset, seed stack, last region size).
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLOOD_FILL_INITIAL_SEEDS 1024
+
+typedef enum RegionMatch {
+    REGION_SAME_TYPE = 0,   // Same terrain type as the start tile
+    REGION_SAME_OWNER,      // Same owner as the start tile
+    REGION_WALKABLE,        // Walkable tiles
+    REGION_CUSTOM           // Caller-provided RegionPredicate
+} RegionMatch;
+
+typedef bool (*RegionPredicate)(const Map* map, int tileIndex, void* userData);
+
+typedef struct FloodFill {
+    uint32_t* visited;      // One bit per tile index: tile belongs to the last region
+    int wordCount;          // Number of 32-bit words in visited
+    int* seeds;             // Pending seed tile indices
+    int seedCapacity;
+    int regionCount;        // Number of tiles in the last region
+} FloodFill;
+
+FloodFill CreateFloodFill(const Map* map) {
+    FloodFill fill = { 0 };
+    fill.wordCount = (map->tileCount + 31) / 32;
+    fill.visited = (uint32_t*)calloc(fill.wordCount, sizeof(uint32_t));
+    fill.seeds = (int*)malloc(FLOOD_FILL_INITIAL_SEEDS * sizeof(int));
+    if (fill.seeds != NULL) fill.seedCapacity = FLOOD_FILL_INITIAL_SEEDS;
+    return fill;
+}
+
+void DestroyFloodFill(FloodFill* fill) {
+    free(fill->visited);
+    free(fill->seeds);
+    fill->visited = NULL;
+    fill->seeds = NULL;
+    fill->wordCount = 0;
+    fill->seedCapacity = 0;
+    fill->regionCount = 0;
+}
+
+bool IsTileInRegion(const FloodFill* fill, int tileIndex) {
+    return (fill->visited[tileIndex >> 5] >> (tileIndex & 31)) & 1u;
+}
+
+// Returns the first region index greater than 'after' (pass -1 to start), or -1 when done
+int NextRegionTile(const FloodFill* fill, int after) {
+    int index = after + 1;
+    int word = index >> 5;
+    if (word >= fill->wordCount) {
+        return -1;
+    }
+
+    uint32_t bits = fill->visited[word] & (~0u << (index & 31));
+    while (bits == 0) {
+        word++;
+        if (word >= fill->wordCount) {
+            return -1;
+        }
+        bits = fill->visited[word];
+    }
+    return word * 32 + __builtin_ctz(bits);
+}
+
+typedef struct RegionTest {
+    RegionMatch match;
+    TileType type;
+    int owner;
+    RegionPredicate predicate;
+    void* userData;
+} RegionTest;
+
+static inline bool regionMatches(const Map* map, const RegionTest* test, int index) {
+    const Tile* tile = &map->tiles[index];
+    switch (test->match) {
+        case REGION_SAME_TYPE:  return tile->type == test->type;
+        case REGION_SAME_OWNER: return tile->owner == test->owner;
+        case REGION_WALKABLE:   return tile->isWalkable;
+        default:                return test->predicate(map, index, test->userData);
+    }
+}
+
+static bool pushSeed(FloodFill* fill, int* seedCount, int index) {
+    if (*seedCount == fill->seedCapacity) {
+        int capacity = (fill->seedCapacity > 0) ? fill->seedCapacity * 2 : FLOOD_FILL_INITIAL_SEEDS;
+        int* seeds = (int*)realloc(fill->seeds, capacity * sizeof(int));
+        if (seeds == NULL) {
+            TraceLog(LOG_ERROR, "Failed to grow flood fill seed stack to %d seeds", capacity);
+            return false;
+        }
+        fill->seeds = seeds;
+        fill->seedCapacity = capacity;
+    }
+    fill->seeds[(*seedCount)++] = index;
+    return true;
+}
+
+static void markSpan(FloodFill* fill, int first, int last) {
+    int firstWord = first >> 5;
+    int lastWord = last >> 5;
+    for (int w = firstWord; w <= lastWord; w++) {
+        uint32_t mask = ~0u;
+        if (w == firstWord) mask &= ~0u << (first & 31);
+        if (w == lastWord) mask &= ~0u >> (31 - (last & 31));
+        fill->visited[w] |= mask;
+    }
+}
+
+// Pushes one seed per run of unvisited matching tiles of row r within [qFrom, qTo]. Returns
+// false if the seed stack could not grow.
+static bool scanRow(FloodFill* fill, int* seedCount, const Map* map, const RegionTest* test, int r, int qFrom, int qTo) {
+    int firstIndex, qMin, qMax;
+    if (!GetMapRow(map, r, &firstIndex, &qMin, &qMax)) {
+        return true;
+    }
+    if (qFrom < qMin) qFrom = qMin;
+    if (qTo > qMax) qTo = qMax;
+
+    bool inRun = false;
+    for (int i = firstIndex + (qFrom - qMin); i <= firstIndex + (qTo - qMin); i++) {
+        if (!IsTileInRegion(fill, i) && regionMatches(map, test, i)) {
+            if (!inRun) {
+                if (!pushSeed(fill, seedCount, i)) return false;
+                inRun = true;
+            }
+        }
+        else {
+            inRun = false;
+        }
+    }
+    return true;
+}
+
+// Fills the region connected to 'start' whose tiles satisfy 'match' (REGION_SAME_TYPE and
+// REGION_SAME_OWNER compare against the start tile; predicate/userData are only used by
+// REGION_CUSTOM). The region stays in the fill's visited bitset until the next call. If
+// tileIndices is not NULL, up to maxIndices region tiles are written to it in span order.
+// Returns the number of tiles in the region (0 if the start tile is outside the map or does
+// not match), or -1 if the seed stack ran out of memory: the region is then left empty, never
+// truncated.
+int FloodFillRegion(FloodFill* fill, const Map* map, Hex start, RegionMatch match, RegionPredicate predicate, void* userData, int* tileIndices, int maxIndices) {
+    memset(fill->visited, 0, fill->wordCount * sizeof(uint32_t));
+    fill->regionCount = 0;
+
+    int startIndex = GetTileIndex(map, start);
+    if (startIndex < 0) {
+        return 0;
+    }
+
+    RegionTest test = { match, map->tiles[startIndex].type, map->tiles[startIndex].owner, predicate, userData };
+    if (match == REGION_CUSTOM && predicate == NULL) {
+        return 0;
+    }
+
+    int seedCount = 0;
+    int written = 0;
+    bool complete = pushSeed(fill, &seedCount, startIndex);
+
+    while (complete && seedCount > 0) {
+        int seed = fill->seeds[--seedCount];
+        if (IsTileInRegion(fill, seed) || !regionMatches(map, &test, seed)) {
+            continue;   // Already reached through another run
+        }
+
+        // Widen the seed to the full span of the region in its row
+        int r = map->tiles[seed].position.r;
+        int firstIndex = 0, qMin = 0, qMax = 0;
+        GetMapRow(map, r, &firstIndex, &qMin, &qMax);
+        int lastIndex = firstIndex + (qMax - qMin);
+
+        int left = seed;
+        while (left > firstIndex && !IsTileInRegion(fill, left - 1) && regionMatches(map, &test, left - 1)) left--;
+        int right = seed;
+        while (right < lastIndex && !IsTileInRegion(fill, right + 1) && regionMatches(map, &test, right + 1)) right++;
+
+        markSpan(fill, left, right);
+        fill->regionCount += right - left + 1;
+        if (tileIndices != NULL) {
+            for (int i = left; i <= right && written < maxIndices; i++) {
+                tileIndices[written++] = i;
+            }
+        }
+
+        int qLeft = qMin + (left - firstIndex);
+        int qRight = qMin + (right - firstIndex);
+        complete = scanRow(fill, &seedCount, map, &test, r - 1, qLeft, qRight + 1) &&
+                   scanRow(fill, &seedCount, map, &test, r + 1, qLeft - 1, qRight);
+    }
+
+    if (!complete) {
+        memset(fill->visited, 0, fill->wordCount * sizeof(uint32_t));
+        fill->regionCount = 0;
+        return -1;
+    }
+    return fill->regionCount;
+}
@@ -0,0 +1,181 @@
+/*
+    This is a utility file for flow fields: paths from every tile of a hex map to one goal.
+
+    When many units head for the same destination, running A* per unit repeats the same work.
+    A flow field is built with a single Dijkstra search that starts at the goal and runs
+    backwards (costs of reaching the goal, see ExpandPathCosts()); every reached tile then
+    stores the direction of its next step in a one-byte direction plane (a step code, see
+    encodePathStep(), so steps along overlay edges fit too). Any number
+    of units follow the field with one lookup per step, and every route is a cheapest path.
+
+    Fields are cached by goal tile in a small LRU cache. The cache listens to map changes and
+    only drops the fields a change can affect: a changed tile matters to a field if the field
+    reached it or one of its neighbours, including tiles with an overlay edge into the field
+    (anything further away is sealed off by tiles the field could not enter). Dropped fields are rebuilt the next time their goal is requested.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitFlowFieldCache: Creates an empty cache for a map and path profile.
+    - UnloadFlowFieldCache: Frees the cached fields and unregisters from the map.
+    - GetFlowField: Returns the field towards a goal, building it if needed.
+    - GetFlowDirection: Reads the direction of the next step from a tile.
+    - GetFlowFieldStep: Returns the tile index of the next step from a tile.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - FlowField: Goal and per-tile direction plane.
+    - FlowFieldCache: Fields of the most recently used goals and the search state.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+#define FLOW_FIELD_CACHE_SIZE 8     // Goals kept at once
+#define FLOW_DIRECTION_GOAL 6       // Direction plane value of the goal tile
+#define FLOW_DIRECTION_NONE 255     // Direction plane value of tiles that cannot reach the goal
+
+typedef struct FlowField {
+    int goal;                   // Goal tile index, -1 for an unused slot
+    unsigned char* directions;  // Per tile: HexNeighbor() direction or overlay edge of the next step
+    int reachedCount;           // Tiles that can reach the goal, goal included
+    bool valid;                 // False once a map change may have altered the field
+    unsigned int lastUse;       // Cache clock value of the last request
+} FlowField;
+
+typedef struct FlowFieldCache {
+    Map* map;
+    PathProfile profile;
+    FlowField fields[FLOW_FIELD_CACHE_SIZE];
+    unsigned int clock;         // Incremented on every request (LRU order)
+    int builds;                 // Fields built so far
+    PathScratch scratch;        // Search state used while building
+} FlowFieldCache;
+
+// Can a change of this tile alter the field? Tiles the field reached are on its routes;
+// unreached neighbours of reached tiles, and tiles with an overlay edge into the field, may
+// open new ones. For overlay changes the listed tiles are the two ends of the edge.
+static bool flowFieldDependsOn(const Map* map, const FlowField* field, int tileIndex) {
+    if (field->directions[tileIndex] != FLOW_DIRECTION_NONE) {
+        return true;
+    }
+    Hex hex = map->tiles[tileIndex].position;
+    for (int dir = 0; dir < 6; dir++) {
+        int neighbor = GetTileIndex(map, HexNeighbor(hex, dir));
+        if (neighbor >= 0 && field->directions[neighbor] != FLOW_DIRECTION_NONE) return true;
+    }
+    for (int e = FirstOverlayEdgeFrom(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextOut) {
+        if (field->directions[map->overlayEdges[e].to] != FLOW_DIRECTION_NONE) return true;
+    }
+    return false;
+}
+
+static void onFlowFieldMapChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    FlowFieldCache* cache = (FlowFieldCache*)userData;
+    (void)kind;
+    for (int f = 0; f < FLOW_FIELD_CACHE_SIZE; f++) {
+        FlowField* field = &cache->fields[f];
+        if (!field->valid) continue;
+        for (int i = 0; i < count; i++) {
+            if (flowFieldDependsOn(map, field, tileIndices[i])) {
+                field->valid = false;
+                break;
+            }
+        }
+    }
+}
+
+// Reverse Dijkstra from the goal, then one direction per reached tile towards its parent
+static void buildFlowField(FlowFieldCache* cache, FlowField* field) {
+    const Map* map = cache->map;
+    PathScratch* scratch = &cache->scratch;
+    if (field->directions == NULL) {
+        field->directions = (unsigned char*)malloc(map->tileCount * sizeof(unsigned char));
+    }
+
+    field->reachedCount = 0;
+    if (GetPathStepCost(map, &cache->profile, field->goal) != PATH_COST_BLOCKED) {
+        field->reachedCount = ExpandPathCosts(scratch, map, &cache->profile, map->tiles[field->goal].position, NULL, true, 0);
+    }
+
+    for (int i = 0; i < map->tileCount; i++) {
+        unsigned char direction = FLOW_DIRECTION_NONE;
+        if (field->reachedCount > 0 && GetExpandedPathCost(scratch, i) >= 0) {
+            direction = FLOW_DIRECTION_GOAL;
+            int parent = scratch->parent[i];
+            if (parent >= 0) {
+                int cost = scratch->g[i] - scratch->g[parent];
+                direction = (unsigned char)encodePathStep(map, i, parent, cost);
+            }
+        }
+        field->directions[i] = direction;
+    }
+
+    field->valid = true;
+    cache->builds++;
+}
+
+void InitFlowFieldCache(FlowFieldCache* cache, Map* map, PathProfile profile) {
+    *cache = (FlowFieldCache){ 0 };
+    cache->map = map;
+    cache->profile = profile;
+    for (int f = 0; f < FLOW_FIELD_CACHE_SIZE; f++) cache->fields[f].goal = -1;
+    cache->scratch = CreatePathScratch(map);
+    AddMapChangeListener(map, onFlowFieldMapChanged, cache);
+}
+
+void UnloadFlowFieldCache(FlowFieldCache* cache) {
+    if (cache->map == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(cache->map, onFlowFieldMapChanged, cache);
+    for (int f = 0; f < FLOW_FIELD_CACHE_SIZE; f++) {
+        free(cache->fields[f].directions);
+    }
+    DestroyPathScratch(&cache->scratch);
+    *cache = (FlowFieldCache){ 0 };
+}
+
+// Returns the field leading to goal, or NULL if goal is outside the map. A cached field is
+// returned as is; otherwise the least recently used slot is rebuilt for this goal. The field
+// belongs to the cache and may be reused for another goal by later calls, so request it
+// again each turn instead of keeping the pointer (a cache hit costs a few comparisons).
+const FlowField* GetFlowField(FlowFieldCache* cache, Hex goal) {
+    int goalIndex = GetTileIndex(cache->map, goal);
+    if (goalIndex < 0) {
+        return NULL;
+    }
+
+    cache->clock++;
+    FlowField* slot = NULL;
+    for (int f = 0; f < FLOW_FIELD_CACHE_SIZE; f++) {
+        FlowField* field = &cache->fields[f];
+        if (field->goal == goalIndex) {
+            slot = field;
+            break;
+        }
+        if (slot == NULL || field->lastUse < slot->lastUse) slot = field;
+    }
+
+    if (slot->goal != goalIndex || !slot->valid) {
+        slot->goal = goalIndex;
+        buildFlowField(cache, slot);
+    }
+    slot->lastUse = cache->clock;
+    return slot;
+}
+
+// Direction of the next step from a tile: 0-5 (see HexNeighbor()), PATH_STEP_OVERLAY + k to
+// take the k-th overlay edge leaving the tile, FLOW_DIRECTION_GOAL on the goal,
+// FLOW_DIRECTION_NONE if the goal cannot be reached from the tile
+int GetFlowDirection(const FlowField* field, int tileIndex) {
+    return field->directions[tileIndex];
+}
+
+// Tile index of the next step from a tile, -1 on the goal or if the goal cannot be reached
+int GetFlowFieldStep(const Map* map, const FlowField* field, int tileIndex) {
+    int direction = field->directions[tileIndex];
+    if (direction == FLOW_DIRECTION_GOAL || direction == FLOW_DIRECTION_NONE) {
+        return -1;
+    }
+    return decodePathStep(map, tileIndex, direction);
+}
@@ -0,0 +1,280 @@
+/*
+    This is a utility file for fog of war: which tiles each player currently sees and which it
+    has ever seen, kept up to date as units move.
+
+    Every unit that sees is a viewer with a sight radius. A viewer stores the tiles of its
+    field of view (utils_fov.c), and every player has a per-tile count of the viewers that see
+    the tile, plus two bitsets: visible (count > 0) and explored (was ever visible). Adding a
+    viewer counts its tiles up, removing it counts them down, and moving it adds the new view
+    before removing the old one, so tiles both views share never drop to zero. A move touches
+    only the tiles of the two views, never the whole map, and per-tile queries are one bit test.
+
+    Tiles whose visibility changed (for any player) are collected until the caller takes them
+    with GetFogChanges() / ClearFogChanges(), so a fog texture only needs to redraw those.
+    Terrain changes mark the viewers within sight of them; UpdateFogOfWar() recomputes just
+    those views.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitFogOfWar: Allocates the per-player counts and bitsets for a map.
+    - UnloadFogOfWar: Frees the fog and unregisters from the map.
+    - AddFogViewer: Adds a viewer of a player at a hex with a sight radius.
+    - RemoveFogViewer: Removes a viewer and its view.
+    - MoveFogViewer: Moves a viewer, updating only the tiles whose counts change.
+    - UpdateFogOfWar: Recomputes the views that terrain changes may have altered.
+    - IsTileVisibleTo / IsTileExploredBy: Per-tile visibility queries.
+    - GetFogChanges / ClearFogChanges: Tiles whose visibility changed since the last clear.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - FogViewer: Player, position, sight radius and view tiles of one viewer.
+    - FogOfWar: Per-player view counts and bitsets, viewers and the change list.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_FOG_PLAYERS 8
+
+typedef struct FogViewer {
+    int player;             // Owner, -1 while the slot is free
+    int origin;             // Tile index the viewer sees from
+    int radius;             // Sight radius (at most the fog's maxRadius)
+    int count;              // Tiles in its view
+    bool dirty;             // Terrain within sight changed since the view was computed
+    int nextFree;           // Next free slot while the slot is free
+} FogViewer;
+
+typedef struct FogOfWar {
+    Map* map;
+    int playerCount;
+    int maxRadius;
+    int wordCount;                          // 32-bit words per bitset
+    int* viewCount[MAX_FOG_PLAYERS];        // Per player: viewers seeing each tile
+    uint32_t* visible[MAX_FOG_PLAYERS];     // Per player: viewCount > 0
+    uint32_t* explored[MAX_FOG_PLAYERS];    // Per player: ever visible
+
+    FogViewer* viewers;
+    int* viewTiles;                         // viewStride tiles per viewer slot
+    int viewStride;                         // GetFieldOfViewCapacity(maxRadius)
+    int viewerCapacity;
+    int firstFree;                          // Free viewer slot list, -1 if empty
+    bool dirty;                             // Some viewer is dirty
+
+    uint32_t* scratch;                      // Always all zero between calls
+    int* scratchTiles;                      // New view of the viewer being moved
+
+    int* changes;                           // Tiles whose visibility changed, each listed once
+    uint32_t* changed;
+    int changeCount;
+} FogOfWar;
+
+static void onFogMapChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    FogOfWar* fog = (FogOfWar*)userData;
+    if (kind != MAP_CHANGE_TERRAIN) {
+        return;     // Overlay edges do not block sight
+    }
+    for (int v = 0; v < fog->viewerCapacity; v++) {
+        FogViewer* viewer = &fog->viewers[v];
+        if (viewer->player < 0 || viewer->dirty) continue;
+        Hex origin = map->tiles[viewer->origin].position;
+        for (int i = 0; i < count; i++) {
+            if (HexDistance(origin, map->tiles[tileIndices[i]].position) <= viewer->radius) {
+                viewer->dirty = true;
+                fog->dirty = true;
+                break;
+            }
+        }
+    }
+}
+
+// Viewers may see at most maxRadius tiles away
+void InitFogOfWar(FogOfWar* fog, Map* map, int playerCount, int maxRadius) {
+    *fog = (FogOfWar){ 0 };
+    if (playerCount > MAX_FOG_PLAYERS) playerCount = MAX_FOG_PLAYERS;
+    if (maxRadius < 0) maxRadius = 0;
+    fog->map = map;
+    fog->playerCount = playerCount;
+    fog->maxRadius = maxRadius;
+    fog->wordCount = (map->tileCount + 31) / 32;
+    for (int p = 0; p < playerCount; p++) {
+        fog->viewCount[p] = (int*)calloc(map->tileCount, sizeof(int));
+        fog->visible[p] = (uint32_t*)calloc(fog->wordCount, sizeof(uint32_t));
+        fog->explored[p] = (uint32_t*)calloc(fog->wordCount, sizeof(uint32_t));
+    }
+    fog->viewStride = GetFieldOfViewCapacity(maxRadius);
+    fog->firstFree = -1;
+    fog->scratch = (uint32_t*)calloc(fog->wordCount, sizeof(uint32_t));
+    fog->scratchTiles = (int*)malloc(fog->viewStride * sizeof(int));
+    fog->changes = (int*)malloc(map->tileCount * sizeof(int));
+    fog->changed = (uint32_t*)calloc(fog->wordCount, sizeof(uint32_t));
+    AddMapChangeListener(map, onFogMapChanged, fog);
+}
+
+void UnloadFogOfWar(FogOfWar* fog) {
+    if (fog->map == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(fog->map, onFogMapChanged, fog);
+    for (int p = 0; p < MAX_FOG_PLAYERS; p++) {
+        free(fog->viewCount[p]);
+        free(fog->visible[p]);
+        free(fog->explored[p]);
+    }
+    free(fog->viewers);
+    free(fog->viewTiles);
+    free(fog->scratch);
+    free(fog->scratchTiles);
+    free(fog->changes);
+    free(fog->changed);
+    *fog = (FogOfWar){ 0 };
+}
+
+static void recordFogChange(FogOfWar* fog, int tileIndex) {
+    uint32_t bit = 1u << (tileIndex & 31);
+    if (fog->changed[tileIndex >> 5] & bit) {
+        return;
+    }
+    fog->changed[tileIndex >> 5] |= bit;
+    fog->changes[fog->changeCount++] = tileIndex;
+}
+
+static void addFogView(FogOfWar* fog, int player, const int* tiles, int count) {
+    int* viewCount = fog->viewCount[player];
+    for (int k = 0; k < count; k++) {
+        int t = tiles[k];
+        if (viewCount[t]++ > 0) continue;
+        fog->visible[player][t >> 5] |= 1u << (t & 31);
+        fog->explored[player][t >> 5] |= 1u << (t & 31);
+        recordFogChange(fog, t);
+    }
+}
+
+static void removeFogView(FogOfWar* fog, int player, const int* tiles, int count) {
+    int* viewCount = fog->viewCount[player];
+    for (int k = 0; k < count; k++) {
+        int t = tiles[k];
+        if (--viewCount[t] > 0) continue;
+        fog->visible[player][t >> 5] &= ~(1u << (t & 31));
+        recordFogChange(fog, t);
+    }
+}
+
+// Field of view of a viewer into tiles; leaves the scratch bitset clear
+static int computeFogView(FogOfWar* fog, const FogViewer* viewer, int* tiles) {
+    int count = ComputeFieldOfView(fog->map, fog->map->tiles[viewer->origin].position, viewer->radius, fog->scratch, tiles);
+    for (int k = 0; k < count; k++) fog->scratch[tiles[k] >> 5] &= ~(1u << (tiles[k] & 31));
+    return count;
+}
+
+// Recomputes the view of a viewer: new tiles are counted up before the old ones are counted
+// down, so only tiles entering or leaving the view change state
+static void refreshFogViewer(FogOfWar* fog, int id) {
+    FogViewer* viewer = &fog->viewers[id];
+    int* tiles = fog->viewTiles + id * fog->viewStride;
+    int count = computeFogView(fog, viewer, fog->scratchTiles);
+    addFogView(fog, viewer->player, fog->scratchTiles, count);
+    removeFogView(fog, viewer->player, tiles, viewer->count);
+    memcpy(tiles, fog->scratchTiles, count * sizeof(int));
+    viewer->count = count;
+    viewer->dirty = false;
+}
+
+// Adds a viewer of player seeing from origin within radius (clamped to the fog's maxRadius).
+// Returns the viewer id, or -1 if the player or origin is invalid.
+int AddFogViewer(FogOfWar* fog, int player, Hex origin, int radius) {
+    int originIndex = GetTileIndex(fog->map, origin);
+    if (player < 0 || player >= fog->playerCount || originIndex < 0) {
+        return -1;
+    }
+    if (fog->firstFree < 0) {
+        int capacity = (fog->viewerCapacity > 0) ? 2 * fog->viewerCapacity : 64;
+        FogViewer* viewers = (FogViewer*)realloc(fog->viewers, capacity * sizeof(FogViewer));
+        if (viewers == NULL) {
+            return -1;
+        }
+        fog->viewers = viewers;
+        int* viewTiles = (int*)realloc(fog->viewTiles, (size_t)capacity * fog->viewStride * sizeof(int));
+        if (viewTiles == NULL) {
+            return -1;
+        }
+        fog->viewTiles = viewTiles;
+        for (int v = capacity - 1; v >= fog->viewerCapacity; v--) {
+            fog->viewers[v] = (FogViewer){ -1, -1, 0, 0, false, fog->firstFree };
+            fog->firstFree = v;
+        }
+        fog->viewerCapacity = capacity;
+    }
+
+    int id = fog->firstFree;
+    FogViewer* viewer = &fog->viewers[id];
+    fog->firstFree = viewer->nextFree;
+    if (radius < 0) radius = 0;
+    if (radius > fog->maxRadius) radius = fog->maxRadius;
+    *viewer = (FogViewer){ player, originIndex, radius, 0, false, -1 };
+    refreshFogViewer(fog, id);
+    return id;
+}
+
+void RemoveFogViewer(FogOfWar* fog, int id) {
+    if (id < 0 || id >= fog->viewerCapacity || fog->viewers[id].player < 0) {
+        return;
+    }
+    FogViewer* viewer = &fog->viewers[id];
+    removeFogView(fog, viewer->player, fog->viewTiles + id * fog->viewStride, viewer->count);
+    *viewer = (FogViewer){ -1, -1, 0, 0, false, fog->firstFree };
+    fog->firstFree = id;
+}
+
+// Moves a viewer to a new hex (outside the map: ignored). Does nothing if it did not move
+// and its view is up to date.
+void MoveFogViewer(FogOfWar* fog, int id, Hex origin) {
+    int originIndex = GetTileIndex(fog->map, origin);
+    if (id < 0 || id >= fog->viewerCapacity || fog->viewers[id].player < 0 || originIndex < 0) {
+        return;
+    }
+    FogViewer* viewer = &fog->viewers[id];
+    if (originIndex == viewer->origin && !viewer->dirty) {
+        return;
+    }
+    viewer->origin = originIndex;
+    refreshFogViewer(fog, id);
+}
+
+// Recomputes the views of viewers near terrain that changed since the last update. Returns
+// the number of views recomputed.
+int UpdateFogOfWar(FogOfWar* fog) {
+    if (!fog->dirty) {
+        return 0;
+    }
+    int updated = 0;
+    for (int v = 0; v < fog->viewerCapacity; v++) {
+        if (fog->viewers[v].player < 0 || !fog->viewers[v].dirty) continue;
+        refreshFogViewer(fog, v);
+        updated++;
+    }
+    fog->dirty = false;
+    return updated;
+}
+
+bool IsTileVisibleTo(const FogOfWar* fog, int player, int tileIndex) {
+    return (fog->visible[player][tileIndex >> 5] >> (tileIndex & 31)) & 1u;
+}
+
+bool IsTileExploredBy(const FogOfWar* fog, int player, int tileIndex) {
+    return (fog->explored[player][tileIndex >> 5] >> (tileIndex & 31)) & 1u;
+}
+
+// Tiles whose visibility changed for some player since the last ClearFogChanges(), each
+// listed once (the tile may have changed back since)
+const int* GetFogChanges(const FogOfWar* fog, int* count) {
+    *count = fog->changeCount;
+    return fog->changes;
+}
+
+void ClearFogChanges(FogOfWar* fog) {
+    for (int k = 0; k < fog->changeCount; k++) fog->changed[fog->changes[k] >> 5] &= ~(1u << (fog->changes[k] & 31));
+    fog->changeCount = 0;
+}
@@ -0,0 +1,158 @@
+/*
+    This is a utility file for field of view: the tiles a unit can see from its hex within a
+    sight radius, with opaque terrain (see IsTileTypeOpaque()) casting shadows.
+
+    The algorithm is symmetric shadowcasting (Albert Ford, "Symmetric Shadowcasting") adapted
+    to hexes. The hexagon around the origin is split into six triangular sextants; in sextant
+    k the tile at depth d and column c (0 <= c <= d) is origin + d * D[k] + c * D[k + 2], so
+    row d of every sextant is one side of ring d. This is an affine image of an octant of a
+    square grid, and lines stay lines under it, so the square-grid algorithm carries over
+    unchanged: rows are scanned outwards between a start and an end slope, every opaque tile
+    narrows the slopes of the rows behind it, and a floor tile is only visible if its center
+    lies within the slopes. That last rule makes the result symmetric: if A sees B, B sees A.
+
+    Slopes are kept as exact fractions, so there is no rounding. The only state is the
+    recursion (one level per row, at most radius deep); results go to a caller-provided
+    bitset and optional tile list, so computing a view never allocates.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - GetFieldOfViewCapacity: Returns the most tiles a view of some radius can contain.
+    - ComputeFieldOfView: Marks the tiles visible from an origin within a radius.
+    - IsTileVisible: Checks one tile of a visibility bitset.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - FovSlope: Exact slope (fraction) bounding the visible part of a sextant row.
+    - FovScan: Origin, sextant and outputs of the view being computed.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct FovSlope {
+    int num;                // Column offset, in half tiles
+    int den;                // Depth, in half tiles (> 0)
+} FovSlope;
+
+typedef struct FovScan {
+    const Map* map;
+    Hex origin;
+    Hex depthStep;          // D[k]: one row further out
+    Hex columnStep;         // D[k + 2]: one column further along the row
+    int radius;
+    uint32_t* visible;      // One bit per tile index
+    int* tiles;             // Newly visible tiles, may be NULL
+    int count;
+} FovScan;
+
+// Tiles of the hexagon of a radius: the size a tile list passed to ComputeFieldOfView() needs
+int GetFieldOfViewCapacity(int radius) {
+    return 3 * radius * (radius + 1) + 1;
+}
+
+bool IsTileVisible(const uint32_t* visible, int tileIndex) {
+    return (visible[tileIndex >> 5] >> (tileIndex & 31)) & 1u;
+}
+
+// Tile of the current sextant at a depth and column, -1 if it is outside the map
+static inline int fovTile(const FovScan* scan, int depth, int column) {
+    Hex hex = MakeHex(scan->origin.q + depth * scan->depthStep.q + column * scan->columnStep.q,
+                      scan->origin.r + depth * scan->depthStep.r + column * scan->columnStep.r,
+                      scan->origin.s + depth * scan->depthStep.s + column * scan->columnStep.s);
+    return GetTileIndex(scan->map, hex);
+}
+
+// Tiles outside the map block sight like rocks
+static inline bool isFovOpaque(const FovScan* scan, int tileIndex) {
+    return tileIndex < 0 || IsTileTypeOpaque(scan->map->tiles[tileIndex].type);
+}
+
+static void revealFovTile(FovScan* scan, int tileIndex) {
+    uint32_t bit = 1u << (tileIndex & 31);
+    if (scan->visible[tileIndex >> 5] & bit) {
+        return;
+    }
+    scan->visible[tileIndex >> 5] |= bit;
+    if (scan->tiles != NULL) scan->tiles[scan->count] = tileIndex;
+    scan->count++;
+}
+
+// Slope through the near edge of a tile: (2 * column - 1) / (2 * depth)
+static inline FovSlope fovEdgeSlope(int depth, int column) {
+    return (FovSlope){ 2 * column - 1, 2 * depth };
+}
+
+// Is the tile center within [start, end]?
+static inline bool isFovSymmetric(int depth, int column, FovSlope start, FovSlope end) {
+    return depth * start.num <= column * start.den && column * end.den <= depth * end.num;
+}
+
+// floor(x / y) for y > 0
+static inline int fovFloorDiv(int x, int y) {
+    return (x >= 0) ? x / y : -((-x + y - 1) / y);
+}
+
+// Scans one row of a sextant between two slopes and recurses into the rows behind its
+// transparent runs
+static void scanFovRow(FovScan* scan, int depth, FovSlope start, FovSlope end) {
+    if (depth > scan->radius) {
+        return;
+    }
+
+    // Columns whose centers are within [start, end], ties widening the row:
+    // round_ties_up(depth * start) .. round_ties_down(depth * end)
+    int first = fovFloorDiv(2 * depth * start.num + start.den, 2 * start.den);
+    int last = -fovFloorDiv(-(2 * depth * end.num - end.den), 2 * end.den);
+    if (first < 0) first = 0;
+    if (last > depth) last = depth;
+
+    int previous = -1;              // -1: none yet, 0: transparent, 1: opaque
+    for (int column = first; column <= last; column++) {
+        int tileIndex = fovTile(scan, depth, column);
+        bool opaque = isFovOpaque(scan, tileIndex);
+
+        // Walls are seen if any part of them is; floors only if their center is in view
+        if (tileIndex >= 0 && (opaque || isFovSymmetric(depth, column, start, end))) {
+            revealFovTile(scan, tileIndex);
+        }
+        if (previous == 1 && !opaque) {
+            start = fovEdgeSlope(depth, column);
+        }
+        if (previous == 0 && opaque) {
+            scanFovRow(scan, depth + 1, start, fovEdgeSlope(depth, column));
+        }
+        previous = opaque ? 1 : 0;
+    }
+    if (previous == 0) {
+        scanFovRow(scan, depth + 1, start, end);
+    }
+}
+
+// Marks every tile visible from origin within radius in the visible bitset (one bit per tile
+// index, (tileCount + 31) / 32 words). Bits already set are kept, so the views of several
+// units can be merged into one bitset. If tiles is not NULL it receives the tiles this call
+// newly marked (room for GetFieldOfViewCapacity(radius) tiles). Returns the number of newly
+// marked tiles; 0 if origin is outside the map. The origin itself is always visible.
+int ComputeFieldOfView(const Map* map, Hex origin, int radius, uint32_t* visible, int* tiles) {
+    FovScan scan = { 0 };
+    scan.map = map;
+    scan.origin = origin;
+    scan.radius = radius;
+    scan.visible = visible;
+    scan.tiles = tiles;
+
+    int originIndex = GetTileIndex(map, origin);
+    if (originIndex < 0) {
+        return 0;
+    }
+    revealFovTile(&scan, originIndex);
+
+    for (int k = 0; k < 6; k++) {
+        scan.depthStep = HexDirection(k);
+        scan.columnStep = HexDirection((k + 2) % 6);
+        scanFovRow(&scan, 1, (FovSlope){ 0, 1 }, (FovSlope){ 1, 1 });
+    }
+    return scan.count;
+}
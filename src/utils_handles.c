@@ -0,0 +1,169 @@
+/*
+    This is a utility file for handles: 32-bit references to pooled objects that can be held
+    across mutations and are detected as stale once the object is gone.
+
+    A handle packs a slot index (low HANDLE_INDEX_BITS bits) and the slot's generation (high
+    bits). A HandlePool stores fixed-size items in one array of slots plus a generation per
+    slot; freeing a slot increments its generation, so every handle to the old item stops
+    matching and lookups of it fail with one compare. Free slots form a list threaded through
+    the slots, so allocating and freeing are O(1) and reuse memory: the pool only grows (and
+    calls realloc) when more items are alive at once than ever before, never in steady state.
+
+    Generations start at 1, so 0 is never a valid handle (NULL_HANDLE). A slot whose
+    generation would wrap around is retired instead of reused, so a stale handle can never
+    become valid again.
+
+    Item pointers (GetHandleItem()) are only valid until the pool grows; handles stay valid
+    until the item is freed.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitHandlePool: Creates a pool of items of some size.
+    - UnloadHandlePool: Frees the pool.
+    - AllocHandle: Allocates a zeroed item and returns its handle.
+    - FreeHandle: Frees the item of a handle.
+    - IsHandleValid: Checks whether a handle refers to a live item, in O(1).
+    - GetHandleItem: Returns the item of a handle, NULL if it is stale.
+    - GetHandleIndex: Returns the slot index of a handle (for side arrays indexed by slot).
+    - GetHandleAt: Returns the handle of the live item in a slot.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - Handle: Slot index and generation packed into 32 bits.
+    - HandlePool: Item slots, per-slot generations and the free slot list.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HANDLE_INDEX_BITS 20                                // Up to 1M live items per pool
+#define HANDLE_MAX_SLOTS (1 << HANDLE_INDEX_BITS)
+#define HANDLE_MAX_GENERATION ((1u << (32 - HANDLE_INDEX_BITS)) - 1)
+#define NULL_HANDLE 0u
+#define HANDLE_FREE_SLOT 0x80000000u                        // Generation flag of free slots
+
+typedef uint32_t Handle;
+
+typedef struct HandlePool {
+    unsigned char* items;       // capacity * itemSize bytes
+    int itemSize;
+    uint32_t* generations;      // Per slot: generation, with HANDLE_FREE_SLOT while free
+    int* nextFree;              // Per slot: next free slot while it is free
+    int capacity;               // Slots allocated
+    int slotCount;              // Slots ever used (the rest of capacity is untouched)
+    int firstFree;              // Free slot list, -1 if empty
+    int count;                  // Live items
+} HandlePool;
+
+static inline Handle makeHandle(int index, uint32_t generation) {
+    return (generation << HANDLE_INDEX_BITS) | (uint32_t)index;
+}
+
+static inline uint32_t handleGeneration(Handle handle) {
+    return handle >> HANDLE_INDEX_BITS;
+}
+
+int GetHandleIndex(Handle handle) {
+    return (int)(handle & (HANDLE_MAX_SLOTS - 1));
+}
+
+// Pool of items of itemSize bytes with room for initialCapacity items before it grows
+void InitHandlePool(HandlePool* pool, int itemSize, int initialCapacity) {
+    *pool = (HandlePool){ 0 };
+    pool->itemSize = (itemSize > 0) ? itemSize : 1;
+    pool->firstFree = -1;
+    if (initialCapacity > HANDLE_MAX_SLOTS) initialCapacity = HANDLE_MAX_SLOTS;
+    if (initialCapacity > 0) {
+        pool->items = (unsigned char*)malloc((size_t)initialCapacity * pool->itemSize);
+        pool->generations = (uint32_t*)malloc(initialCapacity * sizeof(uint32_t));
+        pool->nextFree = (int*)malloc(initialCapacity * sizeof(int));
+        if (pool->items != NULL && pool->generations != NULL && pool->nextFree != NULL) pool->capacity = initialCapacity;
+    }
+}
+
+void UnloadHandlePool(HandlePool* pool) {
+    free(pool->items);
+    free(pool->generations);
+    free(pool->nextFree);
+    *pool = (HandlePool){ 0 };
+}
+
+static bool growHandlePool(HandlePool* pool) {
+    if (pool->capacity == HANDLE_MAX_SLOTS) {
+        return false;
+    }
+    int capacity = (pool->capacity > 0) ? 2 * pool->capacity : 64;
+    if (capacity > HANDLE_MAX_SLOTS) capacity = HANDLE_MAX_SLOTS;
+    unsigned char* items = (unsigned char*)realloc(pool->items, (size_t)capacity * pool->itemSize);
+    if (items != NULL) pool->items = items;
+    uint32_t* generations = (uint32_t*)realloc(pool->generations, capacity * sizeof(uint32_t));
+    if (generations != NULL) pool->generations = generations;
+    int* nextFree = (int*)realloc(pool->nextFree, capacity * sizeof(int));
+    if (nextFree != NULL) pool->nextFree = nextFree;
+    if (items == NULL || generations == NULL || nextFree == NULL) {
+        return false;
+    }
+    pool->capacity = capacity;
+    return true;
+}
+
+// Allocates a zeroed item; NULL_HANDLE if the pool is full or out of memory
+Handle AllocHandle(HandlePool* pool) {
+    int index = pool->firstFree;
+    uint32_t generation = 1;
+    if (index >= 0) {
+        pool->firstFree = pool->nextFree[index];
+        generation = pool->generations[index] & ~HANDLE_FREE_SLOT;
+    }
+    else {
+        if (pool->slotCount == pool->capacity && !growHandlePool(pool)) {
+            return NULL_HANDLE;
+        }
+        index = pool->slotCount++;
+    }
+    pool->generations[index] = generation;
+    memset(pool->items + (size_t)index * pool->itemSize, 0, pool->itemSize);
+    pool->count++;
+    return makeHandle(index, generation);
+}
+
+bool IsHandleValid(const HandlePool* pool, Handle handle) {
+    int index = GetHandleIndex(handle);
+    return index < pool->slotCount && pool->generations[index] == handleGeneration(handle);
+}
+
+// Frees the item of a handle; every handle to it becomes stale. Returns false if it already was.
+bool FreeHandle(HandlePool* pool, Handle handle) {
+    if (!IsHandleValid(pool, handle)) {
+        return false;
+    }
+    int index = GetHandleIndex(handle);
+    uint32_t generation = handleGeneration(handle) + 1;
+    pool->count--;
+    if (generation > HANDLE_MAX_GENERATION) {
+        pool->generations[index] = HANDLE_FREE_SLOT;    // Retired: never handed out again
+        return true;
+    }
+    pool->generations[index] = generation | HANDLE_FREE_SLOT;
+    pool->nextFree[index] = pool->firstFree;
+    pool->firstFree = index;
+    return true;
+}
+
+// Item of a handle, NULL if the handle is stale
+void* GetHandleItem(const HandlePool* pool, Handle handle) {
+    if (!IsHandleValid(pool, handle)) {
+        return NULL;
+    }
+    return pool->items + (size_t)GetHandleIndex(handle) * pool->itemSize;
+}
+
+// Handle of the live item in a slot (the inverse of GetHandleIndex()), NULL_HANDLE if it is free
+Handle GetHandleAt(const HandlePool* pool, int index) {
+    if (index < 0 || index >= pool->slotCount || (pool->generations[index] & HANDLE_FREE_SLOT)) {
+        return NULL_HANDLE;
+    }
+    return makeHandle(index, pool->generations[index]);
+}
@@ -15,10 +15,24 @@
     - HexLength: Computes the length of a hex from the origin.
     - HexEquals: Checks if two hexes are equal.
     - HexDirection: Returns the direction vector for a given direction index.
+    - HexLineDraw: Returns the hexes on a straight line between two hexes.
     - CreateMap: Creates a map with tiles in a given radius around center.
     - DestroyMap: Frees the memory allocated for the map.
+    - CloneMap: Creates an independent copy of a map's tiles (e.g. a snapshot for worker threads).
+    - GetTileIndex: Returns the array index of the tile at a hex position in O(1).
+    - GetMapRow: Returns the index span and q range of one map row.
     - GetTileAt: Retrieves a tile at a specific hex position.
     - SetTileType: Changes the terrain type of a tile.
+    - SetTileTypes: Changes the terrain type of many tiles with a single change notification.
+    - SetTileTypeList: Like SetTileTypes, but with a terrain type per tile (used to revert edits).
+    - IsTileTypeWalkable: Returns whether units can move through a terrain type.
+    - IsTileTypeOpaque: Returns whether a terrain type blocks line of sight.
+    - AddOverlayEdge: Links two tiles with a directed overlay edge (hyperlane, wormhole).
+    - RemoveOverlayEdge: Removes an overlay edge.
+    - FindOverlayEdge: Returns the overlay edge from one tile to another.
+    - FirstOverlayEdgeFrom / FirstOverlayEdgeTo: Start the overlay edge lists of a tile.
+    - AddMapChangeListener: Registers a callback for terrain and overlay changes.
+    - RemoveMapChangeListener: Unregisters a change callback.
     - SetTileSelected: Sets the selection state of a tile.
     - GetTileColor: Returns the color associated with a tile type.
 
@@ -29,6 +43,9 @@
     - TileType: Enumeration of terrain types (GRASS, WATER, ROCKS, etc.).
     - Tile: Game tile with position, type, and properties.
     - Map: Structure to hold a hexagonal map with center, size, and tile array.
+    - MapOverlayEdge: Directed edge between two tiles that need not be neighbours.
+    - MapChangeKind: What a change notification is about (terrain or overlay edges).
+    - MapChangeListener: Callback notified with the indices of changed tiles.
     - Direction vectors for hex neighbors.
     - Layout: Structure to define hex layout (orientation, size, origin).
     - Orientation: Structure to define hex orientation (flat-topped or pointy-topped).
@@ -37,6 +54,7 @@
 
 #include <raylib.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define SQRT3 1.73205080757f // Square root of 3
 
@@ -62,7 +80,8 @@ typedef enum TileType {
     TILE_WATER,
     TILE_ROCKS,
     TILE_SAND,
-    TILE_FOREST
+    TILE_FOREST,
+    TILE_TYPE_COUNT     // Number of terrain types (not a terrain)
 } TileType;
 
 typedef struct Tile {
@@ -70,14 +89,60 @@ typedef struct Tile {
     TileType type;      // Terrain type
     bool isWalkable;    // Can units move through?
     bool isSelected;    // Is this tile currently selected?
+    int owner;          // Player that owns the tile (0 = nobody)
 } Tile;
 
+#define MAX_MAP_LISTENERS 8 // Change listeners per map
+#define MAX_TILE_OVERLAY_EDGES 64   // Overlay edges leaving (or entering) one tile
+
+// Overlay edges connect tiles that need not be neighbours (hyperlanes, wormholes). They are
+// directed; a two-way link is two edges. Every tile heads two intrusive lists into the edge
+// pool, one of the edges leaving it and one of the edges entering it, so searches find the
+// edges of a tile in O(1). Crossing an edge costs its own cost instead of the terrain cost
+// of the tile entered, which must still be enterable.
+typedef struct MapOverlayEdge {
+    int from;           // Tile the edge leaves, -1 for a free pool slot
+    int to;             // Tile the edge enters
+    int cost;           // Cost of crossing the edge (> 0)
+    int nextOut;        // Next edge leaving from (next free slot for free slots), -1 at the end
+    int nextIn;         // Next edge entering to, -1 at the end
+} MapOverlayEdge;
+
+typedef enum MapChangeKind {
+    MAP_CHANGE_TERRAIN = 0,     // The terrain of the listed tiles changed
+    MAP_CHANGE_OVERLAY          // The overlay edge between the two listed tiles (from, to) was added, changed or removed
+} MapChangeKind;
+
+struct Map;
+
+// Called once per change batch with the kind of change and the indices of the tiles it
+// touched. Listeners must not change the map from inside the callback.
+typedef void (*MapChangeCallback)(const struct Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData);
+
+typedef struct MapChangeListener {
+    MapChangeCallback callback;
+    void* userData;
+} MapChangeListener;
+
+// Tiles are stored row by row (r ascending, then q ascending), so every row of the
+// map is a contiguous span of the tile array and tile indices can be computed directly.
 typedef struct Map {
     Point center;       // Center position (origin) of hex (0,0,0)
     Point hexSize;      // Size of each hex
     int radius;         // Map radius (tiles from center)
     Tile* tiles;        // Dynamic array of tiles
     int tileCount;      // Number of tiles in the map
+    unsigned int revision;  // Incremented on every terrain or overlay change batch
+    int* changedIndices;    // Scratch list of changed tiles handed to listeners
+    MapChangeListener listeners[MAX_MAP_LISTENERS];
+    int listenerCount;
+
+    MapOverlayEdge* overlayEdges;   // Overlay edge pool (NULL until the first edge is added)
+    int overlayCapacity;
+    int overlayCount;       // Overlay edges in use
+    int overlayFree;        // First free pool slot, -1 if none
+    int* overlayOut;        // Per tile: first overlay edge leaving it, -1 if none
+    int* overlayIn;         // Per tile: first overlay edge entering it, -1 if none
 } Map;
 
 FractionalHex MakeFractionalHex(float q, float r, float s) {
@@ -184,6 +249,24 @@ Hex HexNeighbor(Hex hex, int direction) {
     return HexAdd(hex, HexDirection(direction));
 }
 
+// Writes up to maxHexes hexes from a to b (inclusive) and returns how many were written
+int HexLineDraw(Hex a, Hex b, Hex* hexes, int maxHexes) {
+    int n = HexDistance(a, b);
+    int count = 0;
+
+    // Nudge the endpoints so points exactly between two hexes always round the same way
+    float aq = a.q + 1e-6f, ar = a.r + 1e-6f, as = a.s - 2e-6f;
+    float bq = b.q + 1e-6f, br = b.r + 1e-6f, bs = b.s - 2e-6f;
+    for (int i = 0; i <= n && count < maxHexes; i++) {
+        float t = (n > 0) ? (float)i / n : 0.0f;
+        float q = aq + (bq - aq) * t;
+        float r = ar + (br - ar) * t;
+        float s = as + (bs - as) * t;
+        hexes[count++] = HexRound((FractionalHex){ q, r, s });
+    }
+    return count;
+}
+
 typedef struct Orientation {
     float f0, f1, f2, f3;
     float b0, b1, b2, b3;
@@ -261,11 +344,20 @@ Map CreateMap(Point center, Point hexSize, int radius) {
     // Calculate maximum number of tiles (3 * radius^2 + 3 * radius + 1)
     int maxTiles = 3 * radius * radius + 3 * radius + 1;
     map.tiles = (Tile*)malloc(maxTiles * sizeof(Tile));
+    map.changedIndices = (int*)malloc(maxTiles * sizeof(int));
     map.tileCount = 0;
+    map.revision = 0;
+    map.listenerCount = 0;
+    map.overlayEdges = NULL;
+    map.overlayCapacity = 0;
+    map.overlayCount = 0;
+    map.overlayFree = -1;
+    map.overlayOut = NULL;
+    map.overlayIn = NULL;
     
-    // Populate map with tiles
-    for (int q = -radius; q <= radius; q++) {
-        for (int r = -radius; r <= radius; r++) {
+    // Populate map with tiles, row by row
+    for (int r = -radius; r <= radius; r++) {
+        for (int q = -radius; q <= radius; q++) {
             int s = -q - r;
             if (abs(s) <= radius) {
                 Tile tile;
@@ -273,6 +365,7 @@ Map CreateMap(Point center, Point hexSize, int radius) {
                 tile.type = TILE_GRASS;  // Default terrain type
                 tile.isWalkable = true;  // Grass is walkable by default
                 tile.isSelected = false;
+                tile.owner = 0;
                 map.tiles[map.tileCount] = tile;
                 map.tileCount++;
             }
@@ -282,32 +375,289 @@ Map CreateMap(Point center, Point hexSize, int radius) {
     return map;
 }
 
+// Copies the tiles, overlay edges and revision of a map; change listeners are not copied.
+// Free with DestroyMap().
+Map CloneMap(const Map* source) {
+    Map map = *source;
+    map.tiles = (Tile*)malloc(source->tileCount * sizeof(Tile));
+    map.changedIndices = (int*)malloc(source->tileCount * sizeof(int));
+    map.listenerCount = 0;
+    memcpy(map.tiles, source->tiles, source->tileCount * sizeof(Tile));
+    if (source->overlayEdges != NULL) {
+        map.overlayEdges = (MapOverlayEdge*)malloc(source->overlayCapacity * sizeof(MapOverlayEdge));
+        map.overlayOut = (int*)malloc(source->tileCount * sizeof(int));
+        map.overlayIn = (int*)malloc(source->tileCount * sizeof(int));
+        memcpy(map.overlayEdges, source->overlayEdges, source->overlayCapacity * sizeof(MapOverlayEdge));
+        memcpy(map.overlayOut, source->overlayOut, source->tileCount * sizeof(int));
+        memcpy(map.overlayIn, source->overlayIn, source->tileCount * sizeof(int));
+    }
+    return map;
+}
+
 void DestroyMap(Map* map) {
     if (map->tiles != NULL) {
         free(map->tiles);
+        free(map->changedIndices);
+        free(map->overlayEdges);
+        free(map->overlayOut);
+        free(map->overlayIn);
         map->tiles = NULL;
+        map->changedIndices = NULL;
+        map->overlayEdges = NULL;
+        map->overlayOut = NULL;
+        map->overlayIn = NULL;
+        map->overlayCapacity = 0;
+        map->overlayCount = 0;
+        map->overlayFree = -1;
         map->tileCount = 0;
+        map->listenerCount = 0;
     }
 }
 
 // Tile helper functions
 
+// Index of the first tile of row r (rows above the center grow by one tile per row,
+// rows below shrink by one)
+static int mapRowStart(int radius, int r) {
+    if (r <= 0) {
+        int n = r + radius;
+        return n * (radius + 1) + n * (n - 1) / 2;
+    }
+    int centerStart = radius * (radius + 1) + radius * (radius - 1) / 2;
+    return centerStart + r * (2 * radius + 1) - r * (r - 1) / 2;
+}
+
+bool GetMapRow(const Map* map, int r, int* firstIndex, int* qMin, int* qMax) {
+    int radius = map->radius;
+    if (r < -radius || r > radius) {
+        return false;
+    }
+    *firstIndex = mapRowStart(radius, r);
+    *qMin = (-r - radius > -radius) ? -r - radius : -radius;
+    *qMax = (-r + radius < radius) ? -r + radius : radius;
+    return true;
+}
+
+int GetTileIndex(const Map* map, Hex position) {
+    int radius = map->radius;
+    if (abs(position.q) > radius || abs(position.r) > radius || abs(position.s) > radius) {
+        return -1;  // Outside the map
+    }
+    int qMin = (-position.r - radius > -radius) ? -position.r - radius : -radius;
+    return mapRowStart(radius, position.r) + (position.q - qMin);
+}
+
 Tile* GetTileAt(Map* map, Hex position) {
-    for (int i = 0; i < map->tileCount; i++) {
-        if (HexEquals(map->tiles[i].position, position)) {
-            return &map->tiles[i];
+    int index = GetTileIndex(map, position);
+    if (index < 0 || index >= map->tileCount) {
+        return NULL;  // Tile not found
+    }
+    return &map->tiles[index];
+}
+
+bool IsTileTypeWalkable(TileType type) {
+    return (type != TILE_WATER && type != TILE_ROCKS);
+}
+
+bool IsTileTypeOpaque(TileType type) {
+    return (type == TILE_ROCKS);
+}
+
+bool AddMapChangeListener(Map* map, MapChangeCallback callback, void* userData) {
+    if (map->listenerCount == MAX_MAP_LISTENERS) {
+        TraceLog(LOG_ERROR, "Too many map change listeners (max %d)", MAX_MAP_LISTENERS);
+        return false;
+    }
+    map->listeners[map->listenerCount].callback = callback;
+    map->listeners[map->listenerCount].userData = userData;
+    map->listenerCount++;
+    return true;
+}
+
+void RemoveMapChangeListener(Map* map, MapChangeCallback callback, void* userData) {
+    for (int i = 0; i < map->listenerCount; i++) {
+        if (map->listeners[i].callback == callback && map->listeners[i].userData == userData) {
+            map->listeners[i] = map->listeners[--map->listenerCount];
+            return;
         }
     }
-    return NULL;  // Tile not found
+}
+
+static void notifyMapChanged(Map* map, MapChangeKind kind, const int* tileIndices, int count) {
+    if (count == 0) {
+        return;
+    }
+    map->revision++;
+    for (int i = 0; i < map->listenerCount; i++) {
+        map->listeners[i].callback(map, kind, tileIndices, count, map->listeners[i].userData);
+    }
+}
+
+// Bulk terrain change: one pass over the indices, one walkability value for the whole batch and
+// one change notification listing only the tiles that actually changed. Returns that count.
+int SetTileTypes(Map* map, const int* tileIndices, int count, TileType type) {
+    bool walkable = IsTileTypeWalkable(type);
+    int changed = 0;
+
+    for (int i = 0; i < count; i++) {
+        int index = tileIndices[i];
+        if (index < 0 || index >= map->tileCount || map->tiles[index].type == type) {
+            continue;
+        }
+        map->tiles[index].type = type;
+        map->tiles[index].isWalkable = walkable;
+        map->changedIndices[changed++] = index;
+    }
+
+    notifyMapChanged(map, MAP_CHANGE_TERRAIN, map->changedIndices, changed);
+    return changed;
+}
+
+// Same as SetTileTypes, with one terrain type per listed tile
+int SetTileTypeList(Map* map, const int* tileIndices, const TileType* types, int count) {
+    int changed = 0;
+
+    for (int i = 0; i < count; i++) {
+        int index = tileIndices[i];
+        if (index < 0 || index >= map->tileCount || map->tiles[index].type == types[i]) {
+            continue;
+        }
+        map->tiles[index].type = types[i];
+        map->tiles[index].isWalkable = IsTileTypeWalkable(types[i]);
+        map->changedIndices[changed++] = index;
+    }
+
+    notifyMapChanged(map, MAP_CHANGE_TERRAIN, map->changedIndices, changed);
+    return changed;
 }
 
 void SetTileType(Map* map, Hex position, TileType type) {
-    Tile* tile = GetTileAt(map, position);
-    if (tile != NULL) {
-        tile->type = type;
-        // Update walkability based on type
-        tile->isWalkable = (type != TILE_WATER && type != TILE_ROCKS);
+    int index = GetTileIndex(map, position);
+    if (index >= 0) {
+        SetTileTypes(map, &index, 1, type);
+    }
+}
+
+// Overlay edge functions
+
+int FirstOverlayEdgeFrom(const Map* map, int tileIndex) {
+    return (map->overlayOut != NULL) ? map->overlayOut[tileIndex] : -1;
+}
+
+int FirstOverlayEdgeTo(const Map* map, int tileIndex) {
+    return (map->overlayIn != NULL) ? map->overlayIn[tileIndex] : -1;
+}
+
+// Index of the overlay edge from one tile to another, -1 if there is none
+int FindOverlayEdge(const Map* map, int fromIndex, int toIndex) {
+    for (int e = FirstOverlayEdgeFrom(map, fromIndex); e >= 0; e = map->overlayEdges[e].nextOut) {
+        if (map->overlayEdges[e].to == toIndex) return e;
+    }
+    return -1;
+}
+
+static int overlayListLength(const Map* map, int e, bool outgoing) {
+    int length = 0;
+    for (; e >= 0; e = outgoing ? map->overlayEdges[e].nextOut : map->overlayEdges[e].nextIn) length++;
+    return length;
+}
+
+// Adds a directed overlay edge, or changes the cost of the existing one. Returns false if
+// a tile is outside the map, the tiles are the same, cost is not positive or a tile
+// already has MAX_TILE_OVERLAY_EDGES edges.
+bool AddOverlayEdge(Map* map, Hex from, Hex to, int cost) {
+    int fromIndex = GetTileIndex(map, from);
+    int toIndex = GetTileIndex(map, to);
+    if (fromIndex < 0 || toIndex < 0 || fromIndex == toIndex || cost <= 0) {
+        return false;
     }
+    int pair[2] = { fromIndex, toIndex };
+
+    int existing = FindOverlayEdge(map, fromIndex, toIndex);
+    if (existing >= 0) {
+        if (map->overlayEdges[existing].cost != cost) {
+            map->overlayEdges[existing].cost = cost;
+            notifyMapChanged(map, MAP_CHANGE_OVERLAY, pair, 2);
+        }
+        return true;
+    }
+
+    if (map->overlayOut == NULL) {
+        map->overlayOut = (int*)malloc(map->tileCount * sizeof(int));
+        map->overlayIn = (int*)malloc(map->tileCount * sizeof(int));
+        if (map->overlayOut == NULL || map->overlayIn == NULL) {
+            free(map->overlayOut);
+            free(map->overlayIn);
+            map->overlayOut = NULL;
+            map->overlayIn = NULL;
+            return false;
+        }
+        for (int i = 0; i < map->tileCount; i++) {
+            map->overlayOut[i] = -1;
+            map->overlayIn[i] = -1;
+        }
+    }
+    if (overlayListLength(map, map->overlayOut[fromIndex], true) >= MAX_TILE_OVERLAY_EDGES ||
+        overlayListLength(map, map->overlayIn[toIndex], false) >= MAX_TILE_OVERLAY_EDGES) {
+        TraceLog(LOG_WARNING, "Too many overlay edges on one tile (max %d)", MAX_TILE_OVERLAY_EDGES);
+        return false;
+    }
+
+    if (map->overlayFree < 0) {
+        int capacity = (map->overlayCapacity > 0) ? 2 * map->overlayCapacity : 16;
+        MapOverlayEdge* edges = (MapOverlayEdge*)realloc(map->overlayEdges, capacity * sizeof(MapOverlayEdge));
+        if (edges == NULL) {
+            return false;
+        }
+        for (int e = capacity - 1; e >= map->overlayCapacity; e--) {
+            edges[e].from = -1;
+            edges[e].nextOut = map->overlayFree;
+            map->overlayFree = e;
+        }
+        map->overlayEdges = edges;
+        map->overlayCapacity = capacity;
+    }
+
+    int e = map->overlayFree;
+    MapOverlayEdge* edge = &map->overlayEdges[e];
+    map->overlayFree = edge->nextOut;
+    edge->from = fromIndex;
+    edge->to = toIndex;
+    edge->cost = cost;
+    edge->nextOut = map->overlayOut[fromIndex];
+    edge->nextIn = map->overlayIn[toIndex];
+    map->overlayOut[fromIndex] = e;
+    map->overlayIn[toIndex] = e;
+    map->overlayCount++;
+
+    notifyMapChanged(map, MAP_CHANGE_OVERLAY, pair, 2);
+    return true;
+}
+
+// Removes the overlay edge from one hex to another; returns false if there is none
+bool RemoveOverlayEdge(Map* map, Hex from, Hex to) {
+    int fromIndex = GetTileIndex(map, from);
+    int toIndex = GetTileIndex(map, to);
+    int e = (fromIndex >= 0 && toIndex >= 0) ? FindOverlayEdge(map, fromIndex, toIndex) : -1;
+    if (e < 0) {
+        return false;
+    }
+
+    int* link = &map->overlayOut[fromIndex];
+    while (*link != e) link = &map->overlayEdges[*link].nextOut;
+    *link = map->overlayEdges[e].nextOut;
+    link = &map->overlayIn[toIndex];
+    while (*link != e) link = &map->overlayEdges[*link].nextIn;
+    *link = map->overlayEdges[e].nextIn;
+
+    map->overlayEdges[e].from = -1;
+    map->overlayEdges[e].nextOut = map->overlayFree;
+    map->overlayFree = e;
+    map->overlayCount--;
+
+    int pair[2] = { fromIndex, toIndex };
+    notifyMapChanged(map, MAP_CHANGE_OVERLAY, pair, 2);
+    return true;
 }
 
 void SetTileSelected(Map* map, Hex position, bool selected) {
@@ -0,0 +1,415 @@
+/*
+    This is a utility file for hierarchical pathfinding (HPA*) on large hex maps.
+
+    The map is cut into sectors of HPA_SECTOR_SIZE x HPA_SECTOR_SIZE tiles (parallelograms in
+    axial coordinates). Along every border between two sectors, the enterable tile pairs are
+    grouped into contiguous entrances and the middle pair of each entrance becomes a
+    transition: its two tiles are nodes of an abstract graph, linked by a one-step edge. Inside
+    a sector, every pair of nodes is linked with the exact in-sector path cost, precomputed
+    with a Dijkstra search per node. Overlay edges (see MapOverlayEdge) that stay inside one
+    sector are simply part of those searches; the tiles of edges crossing sectors become
+    nodes too, linked by the edge itself.
+
+    A query connects the start and goal to the nodes of their sectors, runs A* over the
+    abstract graph (a few dozen nodes per sector instead of hundreds of tiles) and then refines
+    each abstract edge with an A* search confined to one sector. Paths are close to optimal,
+    not always optimal: they cross sector borders only at transitions and overlay edges.
+
+    The graph listens to map changes and only marks the sectors of changed tiles as dirty;
+    UpdateHpaGraph() then recomputes the entrances on the borders of those sectors and the
+    in-sector costs of the sectors whose nodes may have changed (dirty sectors and their
+    neighbours). Searches reuse the heap helpers and PathScratch of utils_pathfinding.c.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitHpaGraph: Builds the abstract graph of a map for a path profile.
+    - UnloadHpaGraph: Frees the graph and unregisters it from the map.
+    - UpdateHpaGraph: Recomputes the sectors invalidated by map changes.
+    - FindPathHierarchical: Finds a path with the abstract graph.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - HpaSector: Node tiles and in-sector node-to-node costs of one sector.
+    - HpaGraph: Sectors, per-tile transition links and the change tracking state.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HPA_SECTOR_SIZE 16          // Sector edge length in tiles
+#define HPA_MAX_SECTOR_NODES 128    // Transition tiles kept per sector
+#define HPA_MAX_BORDER_EDGES (4 * HPA_SECTOR_SIZE)  // Tile pairs along one sector border
+
+typedef struct HpaSector {
+    int nodes[HPA_MAX_SECTOR_NODES];    // Transition tiles inside the sector, ascending
+    int nodeCount;
+    int* costs;                         // nodeCount x nodeCount in-sector costs (-1: unreachable)
+    bool dirty;                         // Tiles changed since the last update
+} HpaSector;
+
+typedef struct HpaGraph {
+    Map* map;
+    PathProfile profile;
+    int sectorColumns;                  // Sectors along q (and along r)
+    HpaSector* sectors;
+    unsigned char* links;               // Per tile: bit d set if (tile, neighbor d) is a transition
+    bool* rebuild;                      // Update scratch: sector needs new nodes and costs
+    bool dirty;                         // Any sector dirty?
+    PathScratch scratch;                // Search state used while building
+} HpaGraph;
+
+static int hpaSectorOf(const HpaGraph* graph, Hex hex) {
+    int radius = graph->map->radius;
+    return ((hex.r + radius) / HPA_SECTOR_SIZE) * graph->sectorColumns + (hex.q + radius) / HPA_SECTOR_SIZE;
+}
+
+static PathBounds hpaSectorBounds(const HpaGraph* graph, int sector) {
+    int radius = graph->map->radius;
+    PathBounds bounds;
+    bounds.qMin = (sector % graph->sectorColumns) * HPA_SECTOR_SIZE - radius;
+    bounds.rMin = (sector / graph->sectorColumns) * HPA_SECTOR_SIZE - radius;
+    bounds.qMax = bounds.qMin + HPA_SECTOR_SIZE - 1;
+    bounds.rMax = bounds.rMin + HPA_SECTOR_SIZE - 1;
+    return bounds;
+}
+
+static int hpaNodeSlot(const HpaSector* sector, int tile) {
+    for (int i = 0; i < sector->nodeCount; i++) {
+        if (sector->nodes[i] == tile) return i;
+    }
+    return -1;
+}
+
+// Writes the tile indices of a sector (rows are contiguous index runs); returns the count
+static int hpaSectorTiles(const HpaGraph* graph, int sector, int* tiles) {
+    PathBounds bounds = hpaSectorBounds(graph, sector);
+    int count = 0;
+    for (int r = bounds.rMin; r <= bounds.rMax; r++) {
+        int firstIndex, qMin, qMax;
+        if (!GetMapRow(graph->map, r, &firstIndex, &qMin, &qMax)) continue;
+        int q0 = (bounds.qMin > qMin) ? bounds.qMin : qMin;
+        int q1 = (bounds.qMax < qMax) ? bounds.qMax : qMax;
+        for (int q = q0; q <= q1; q++) tiles[count++] = firstIndex + (q - qMin);
+    }
+    return count;
+}
+
+// Recomputes the transitions between a sector and its neighbour in direction-independent
+// order: border tile pairs are visited along the border, runs of enterable pairs form an
+// entrance and the middle pair of each run is linked.
+static void computeBorder(HpaGraph* graph, int sector, int neighborSector) {
+    const Map* map = graph->map;
+    int from[HPA_MAX_BORDER_EDGES];
+    int to[HPA_MAX_BORDER_EDGES];
+    int dirs[HPA_MAX_BORDER_EDGES];
+    int count = 0;
+
+    int tiles[HPA_SECTOR_SIZE * HPA_SECTOR_SIZE];
+    int tileCount = hpaSectorTiles(graph, sector, tiles);
+    for (int t = 0; t < tileCount; t++) {
+        int tile = tiles[t];
+        Hex hex = map->tiles[tile].position;
+        int first = count;
+        for (int dir = 0; dir < 6; dir++) {
+            Hex next = HexNeighbor(hex, dir);
+            int neighbor = GetTileIndex(map, next);
+            if (neighbor < 0 || hpaSectorOf(graph, next) != neighborSector) continue;
+
+            // Clear the old link in both directions
+            graph->links[tile] &= (unsigned char)~(1u << dir);
+            graph->links[neighbor] &= (unsigned char)~(1u << ((dir + 3) % 6));
+            if (count == HPA_MAX_BORDER_EDGES) continue;
+
+            // Keep the pairs of one tile ordered along the border (by neighbor index)
+            int k = count++;
+            while (k > first && to[k - 1] > neighbor) {
+                from[k] = from[k - 1]; to[k] = to[k - 1]; dirs[k] = dirs[k - 1];
+                k--;
+            }
+            from[k] = tile; to[k] = neighbor; dirs[k] = dir;
+        }
+    }
+
+    int runStart = -1;
+    for (int k = 0; k <= count; k++) {
+        bool open = (k < count) &&
+                    GetPathStepCost(map, &graph->profile, from[k]) != PATH_COST_BLOCKED &&
+                    GetPathStepCost(map, &graph->profile, to[k]) != PATH_COST_BLOCKED;
+        bool continues = open && runStart >= 0 &&
+                         HexDistance(map->tiles[from[k - 1]].position, map->tiles[from[k]].position) <= 1 &&
+                         HexDistance(map->tiles[to[k - 1]].position, map->tiles[to[k]].position) <= 1;
+
+        if (runStart >= 0 && !continues) {
+            // Close the entrance [runStart, k - 1] with a transition at its middle pair
+            int m = (runStart + k - 1) / 2;
+            graph->links[from[m]] |= (unsigned char)(1u << dirs[m]);
+            graph->links[to[m]] |= (unsigned char)(1u << ((dirs[m] + 3) % 6));
+            runStart = -1;
+        }
+        if (open && runStart < 0) runStart = k;
+    }
+}
+
+// Does an overlay edge leave or enter the tile's sector at this tile?
+static bool hpaHasOverlayLink(const HpaGraph* graph, int tile) {
+    const Map* map = graph->map;
+    int sector = hpaSectorOf(graph, map->tiles[tile].position);
+    for (int e = FirstOverlayEdgeFrom(map, tile); e >= 0; e = map->overlayEdges[e].nextOut) {
+        if (hpaSectorOf(graph, map->tiles[map->overlayEdges[e].to].position) != sector) return true;
+    }
+    for (int e = FirstOverlayEdgeTo(map, tile); e >= 0; e = map->overlayEdges[e].nextIn) {
+        if (hpaSectorOf(graph, map->tiles[map->overlayEdges[e].from].position) != sector) return true;
+    }
+    return false;
+}
+
+// Collects the sector's transition tiles and computes the in-sector cost between every pair
+static void computeSectorCosts(HpaGraph* graph, int sector) {
+    HpaSector* s = &graph->sectors[sector];
+    s->nodeCount = 0;
+    int tiles[HPA_SECTOR_SIZE * HPA_SECTOR_SIZE];
+    int tileCount = hpaSectorTiles(graph, sector, tiles);
+    int dropped = 0;
+    for (int t = 0; t < tileCount; t++) {
+        if (graph->links[tiles[t]] == 0 && !hpaHasOverlayLink(graph, tiles[t])) continue;
+        if (s->nodeCount < HPA_MAX_SECTOR_NODES) s->nodes[s->nodeCount++] = tiles[t];
+        else dropped++;
+    }
+    if (dropped > 0) {
+        TraceLog(LOG_WARNING, "HPA sector %d has more than %d transitions, %d dropped", sector, HPA_MAX_SECTOR_NODES, dropped);
+    }
+
+    free(s->costs);
+    s->costs = (s->nodeCount > 0) ? (int*)malloc(s->nodeCount * s->nodeCount * sizeof(int)) : NULL;
+
+    PathBounds bounds = hpaSectorBounds(graph, sector);
+    for (int i = 0; i < s->nodeCount; i++) {
+        ExpandPathCosts(&graph->scratch, graph->map, &graph->profile, graph->map->tiles[s->nodes[i]].position, &bounds, false, 0);
+        for (int j = 0; j < s->nodeCount; j++) {
+            s->costs[i * s->nodeCount + j] = GetExpandedPathCost(&graph->scratch, s->nodes[j]);
+        }
+    }
+}
+
+// Terrain changes and overlay edges both only touch the sectors of the listed tiles
+static void onHpaMapChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    HpaGraph* graph = (HpaGraph*)userData;
+    (void)kind;
+    for (int i = 0; i < count; i++) {
+        graph->sectors[hpaSectorOf(graph, map->tiles[tileIndices[i]].position)].dirty = true;
+    }
+    graph->dirty = true;
+}
+
+static void hpaNeighborSectors(const HpaGraph* graph, int sector, int* neighbors) {
+    static const int offsets[6][2] = { { 1, 0 }, { 1, -1 }, { 0, -1 }, { -1, 0 }, { -1, 1 }, { 0, 1 } };
+    int a = sector % graph->sectorColumns;
+    int b = sector / graph->sectorColumns;
+    for (int d = 0; d < 6; d++) {
+        int na = a + offsets[d][0];
+        int nb = b + offsets[d][1];
+        bool inside = (na >= 0 && nb >= 0 && na < graph->sectorColumns && nb < graph->sectorColumns);
+        neighbors[d] = inside ? nb * graph->sectorColumns + na : -1;
+    }
+}
+
+// Recomputes the borders of dirty sectors, then nodes and costs of every sector touching them.
+// Call after map changes and before querying; returns the number of sectors recomputed.
+int UpdateHpaGraph(HpaGraph* graph) {
+    if (!graph->dirty) {
+        return 0;
+    }
+    int sectorCount = graph->sectorColumns * graph->sectorColumns;
+    for (int c = 0; c < sectorCount; c++) graph->rebuild[c] = false;
+
+    for (int c = 0; c < sectorCount; c++) {
+        if (!graph->sectors[c].dirty) continue;
+        int neighbors[6];
+        hpaNeighborSectors(graph, c, neighbors);
+        graph->rebuild[c] = true;
+        for (int d = 0; d < 6; d++) {
+            if (neighbors[d] < 0) continue;
+            computeBorder(graph, c, neighbors[d]);
+            graph->rebuild[neighbors[d]] = true;
+        }
+        graph->sectors[c].dirty = false;
+    }
+
+    int rebuilt = 0;
+    for (int c = 0; c < sectorCount; c++) {
+        if (graph->rebuild[c]) {
+            computeSectorCosts(graph, c);
+            rebuilt++;
+        }
+    }
+    graph->dirty = false;
+    return rebuilt;
+}
+
+void InitHpaGraph(HpaGraph* graph, Map* map, PathProfile profile) {
+    *graph = (HpaGraph){ 0 };
+    graph->map = map;
+    graph->profile = profile;
+    graph->sectorColumns = (2 * map->radius + 1 + HPA_SECTOR_SIZE - 1) / HPA_SECTOR_SIZE;
+    int sectorCount = graph->sectorColumns * graph->sectorColumns;
+    graph->sectors = (HpaSector*)calloc(sectorCount, sizeof(HpaSector));
+    graph->links = (unsigned char*)calloc(map->tileCount, sizeof(unsigned char));
+    graph->rebuild = (bool*)malloc(sectorCount * sizeof(bool));
+    graph->scratch = CreatePathScratch(map);
+
+    // Everything starts dirty: the first update builds the whole graph
+    for (int c = 0; c < sectorCount; c++) graph->sectors[c].dirty = true;
+    graph->dirty = true;
+    UpdateHpaGraph(graph);
+
+    AddMapChangeListener(map, onHpaMapChanged, graph);
+}
+
+void UnloadHpaGraph(HpaGraph* graph) {
+    if (graph->sectors == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(graph->map, onHpaMapChanged, graph);
+    for (int c = 0; c < graph->sectorColumns * graph->sectorColumns; c++) {
+        free(graph->sectors[c].costs);
+    }
+    free(graph->sectors);
+    free(graph->links);
+    free(graph->rebuild);
+    DestroyPathScratch(&graph->scratch);
+    *graph = (HpaGraph){ 0 };
+}
+
+// Finds a path from start to goal through the abstract graph, then refines it sector by
+// sector. Output and return value follow FindPath(); the graph must be up to date
+// (UpdateHpaGraph()). Only the scratch is written, so several threads can query one graph
+// with their own scratches.
+int FindPathHierarchical(const HpaGraph* graph, PathScratch* scratch, Hex start, Hex goal, int* path, int maxPath, int* totalCost) {
+    const Map* map = graph->map;
+    const PathProfile* profile = &graph->profile;
+    int startIndex = GetTileIndex(map, start);
+    int goalIndex = GetTileIndex(map, goal);
+    if (startIndex < 0 || goalIndex < 0) {
+        return 0;
+    }
+    if (startIndex == goalIndex) {
+        if (path != NULL && maxPath >= 1) path[0] = startIndex;
+        if (totalCost != NULL) *totalCost = 0;
+        return 1;
+    }
+    if (GetPathStepCost(map, profile, goalIndex) == PATH_COST_BLOCKED) {
+        return 0;
+    }
+
+    int startSector = hpaSectorOf(graph, start);
+    int goalSector = hpaSectorOf(graph, goal);
+    const HpaSector* s = &graph->sectors[startSector];
+    const HpaSector* gs = &graph->sectors[goalSector];
+    PathBounds startBounds = hpaSectorBounds(graph, startSector);
+    PathBounds goalBounds = hpaSectorBounds(graph, goalSector);
+
+    // Connect start and goal to the nodes of their sectors
+    int startCosts[HPA_MAX_SECTOR_NODES];
+    int goalCosts[HPA_MAX_SECTOR_NODES];
+    ExpandPathCosts(scratch, map, profile, start, &startBounds, false, 0);
+    for (int i = 0; i < s->nodeCount; i++) startCosts[i] = GetExpandedPathCost(scratch, s->nodes[i]);
+    int directCost = (startSector == goalSector) ? GetExpandedPathCost(scratch, goalIndex) : -1;
+    ExpandPathCosts(scratch, map, profile, goal, &goalBounds, true, 0);
+    for (int i = 0; i < gs->nodeCount; i++) goalCosts[i] = GetExpandedPathCost(scratch, gs->nodes[i]);
+
+    // A* over the abstract graph; tiles double as node ids
+    beginPathSearch(scratch);
+    PathHeuristic heuristic = makePathHeuristic(map, profile, goalIndex);
+    relaxPathTile(scratch, startIndex, 0, pathHeuristic(&heuristic, start), -1);
+
+    bool found = false;
+    while (scratch->heapSize > 0) {
+        int current = heapPop(scratch);
+        if (current == goalIndex) {
+            found = true;
+            break;
+        }
+        scratch->expanded++;
+        int g = scratch->g[current];
+
+        if (current == startIndex) {
+            for (int i = 0; i < s->nodeCount; i++) {
+                if (startCosts[i] < 0 || s->nodes[i] == startIndex) continue;
+                relaxPathTile(scratch, s->nodes[i], g + startCosts[i], pathHeuristic(&heuristic, map->tiles[s->nodes[i]].position), current);
+            }
+            if (directCost >= 0) relaxPathTile(scratch, goalIndex, g + directCost, 0, current);
+        }
+
+        // Overlay edges into other sectors (edges inside a sector are part of the in-sector costs)
+        Hex hex = map->tiles[current].position;
+        int sector = hpaSectorOf(graph, hex);
+        for (int e = FirstOverlayEdgeFrom(map, current); e >= 0; e = map->overlayEdges[e].nextOut) {
+            const MapOverlayEdge* edge = &map->overlayEdges[e];
+            Hex next = map->tiles[edge->to].position;
+            if (hpaSectorOf(graph, next) == sector || GetPathStepCost(map, profile, edge->to) == PATH_COST_BLOCKED) continue;
+            relaxPathTile(scratch, edge->to, g + edge->cost, pathHeuristic(&heuristic, next), current);
+        }
+
+        // Only abstract nodes have in-sector and transition edges
+        const HpaSector* cs = &graph->sectors[sector];
+        int slot = hpaNodeSlot(cs, current);
+        if (slot < 0) continue;
+
+        // In-sector edges
+        for (int j = 0; j < cs->nodeCount; j++) {
+            int cost = cs->costs[slot * cs->nodeCount + j];
+            if (j == slot || cost < 0) continue;
+            relaxPathTile(scratch, cs->nodes[j], g + cost, pathHeuristic(&heuristic, map->tiles[cs->nodes[j]].position), current);
+        }
+        // Transition edges into the neighbouring sectors
+        for (int dir = 0; dir < 6; dir++) {
+            if (!(graph->links[current] & (1u << dir))) continue;
+            Hex next = HexNeighbor(hex, dir);
+            int neighbor = GetTileIndex(map, next);
+            relaxPathTile(scratch, neighbor, g + GetPathStepCost(map, profile, neighbor), pathHeuristic(&heuristic, next), current);
+        }
+        // Last leg to the goal
+        if (sector == goalSector && goalCosts[slot] >= 0) {
+            relaxPathTile(scratch, goalIndex, g + goalCosts[slot], 0, current);
+        }
+    }
+    if (!found) {
+        return 0;
+    }
+    if (totalCost != NULL) *totalCost = scratch->g[goalIndex];
+
+    // Abstract route, start first
+    int waypointCount = 0;
+    for (int t = goalIndex; t >= 0; t = scratch->parent[t]) waypointCount++;
+    int w = waypointCount;
+    for (int t = goalIndex; t >= 0; t = scratch->parent[t]) scratch->waypoints[--w] = t;
+
+    // Refine: transitions and overlay edges between sectors are single steps, everything else
+    // is a search inside one sector
+    int length = 1;
+    bool fits = (path != NULL && maxPath >= 1);
+    if (fits) path[0] = startIndex;
+    for (int k = 1; k < waypointCount; k++) {
+        int a = scratch->waypoints[k - 1];
+        int b = scratch->waypoints[k];
+        Hex ha = map->tiles[a].position;
+        Hex hb = map->tiles[b].position;
+        int sector = hpaSectorOf(graph, ha);
+
+        if (sector != hpaSectorOf(graph, hb)) {
+            if (fits && length < maxPath) path[length] = b;
+            length++;
+        }
+        else {
+            PathBounds bounds = hpaSectorBounds(graph, sector);
+            bool room = fits && length - 1 < maxPath;
+            int segment = FindPathInBounds(scratch, map, profile, ha, hb, &bounds,
+                                           room ? path + length - 1 : NULL, room ? maxPath - (length - 1) : 0, NULL);
+            if (segment == 0) return 0;     // Graph out of date
+            length += segment - 1;
+        }
+        if (length > maxPath) fits = false;
+    }
+    return length;
+}
@@ -0,0 +1,247 @@
+/*
+    This is a utility file for influence and threat maps: per-player values spread over the
+    hex map from sources (units, planets, ...) with a configurable falloff.
+
+    Every source adds strength * falloff(distance) to the tiles within the falloff radius of
+    its player's influence plane. The falloff is precomputed once as a hexagonal stencil
+    stored row by row, and since map rows are contiguous in the tile array, stamping a
+    source is one multiply-add loop per row over two contiguous float arrays (restrict
+    pointers, no branches), which compilers vectorize. After all sources are stamped, the
+    threat plane of each player is the sum of every other player's influence.
+
+    Planes are updated in parallel on a WorkerPool (utils_workers.c): the map is split into
+    bands of rows and every (player, band) pair is one job item, so workers write disjoint
+    parts of the planes and need no locks. Every tile sums its sources in the same order
+    whatever worker computes it, so the results do not depend on the thread count.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitInfluenceMap: Allocates the planes of a map for a number of players and a falloff.
+    - UnloadInfluenceMap: Frees the planes and sources.
+    - ClearInfluenceSources: Removes the sources of all players.
+    - AddInfluenceSource: Adds a source of some strength for a player.
+    - UpdateInfluenceMap: Recomputes every influence and threat plane on a worker pool.
+    - GetInfluence / GetThreat: Read a player's influence / enemy influence at a tile.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - InfluenceFalloffType: Shape of the falloff (linear, exponential, constant).
+    - InfluenceFalloff: Falloff shape, radius and decay.
+    - InfluenceSource: Tile and strength of one source.
+    - InfluenceMap: Falloff stencil, per-player sources and planes.
+*/
+
+#include <raylib.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_INFLUENCE_PLAYERS 8
+#define INFLUENCE_BAND_ROWS 32      // Map rows per job item
+
+typedef enum InfluenceFalloffType {
+    INFLUENCE_FALLOFF_LINEAR = 0,   // 1 - d / (radius + 1)
+    INFLUENCE_FALLOFF_EXPONENTIAL,  // decay^d
+    INFLUENCE_FALLOFF_CONSTANT      // 1 within the radius
+} InfluenceFalloffType;
+
+typedef struct InfluenceFalloff {
+    InfluenceFalloffType type;
+    int radius;                     // Tiles beyond this distance get nothing
+    float decay;                    // Per-tile factor of INFLUENCE_FALLOFF_EXPONENTIAL
+} InfluenceFalloff;
+
+typedef struct InfluenceSource {
+    int tileIndex;
+    float strength;
+} InfluenceSource;
+
+typedef struct InfluenceMap {
+    const Map* map;
+    int playerCount;
+    InfluenceFalloff falloff;
+    float* stencil;                 // Falloff weights of the radius hexagon, row by row
+    int* stencilRow;                // Offset of each stencil row (dr = -radius..radius)
+
+    InfluenceSource* sources[MAX_INFLUENCE_PLAYERS];
+    int sourceCount[MAX_INFLUENCE_PLAYERS];
+    int sourceCapacity[MAX_INFLUENCE_PLAYERS];
+
+    float* influence[MAX_INFLUENCE_PLAYERS];   // Per player: own influence per tile
+    float* threat[MAX_INFLUENCE_PLAYERS];      // Per player: sum of the other players' influence
+    float* total;                               // Sum over all players
+    int bandCount;
+} InfluenceMap;
+
+static float influenceWeight(const InfluenceFalloff* falloff, int distance) {
+    switch (falloff->type) {
+        case INFLUENCE_FALLOFF_EXPONENTIAL: return powf(falloff->decay, (float)distance);
+        case INFLUENCE_FALLOFF_CONSTANT:    return 1.0f;
+        default:                            return 1.0f - (float)distance / (float)(falloff->radius + 1);
+    }
+}
+
+// Stencil row dr covers dq = max(-radius, -radius - dr) .. min(radius, radius - dr)
+static inline int stencilFirstQ(int radius, int dr) {
+    return (dr < 0) ? -radius - dr : -radius;
+}
+
+void InitInfluenceMap(InfluenceMap* influence, const Map* map, int playerCount, InfluenceFalloff falloff) {
+    *influence = (InfluenceMap){ 0 };
+    if (playerCount > MAX_INFLUENCE_PLAYERS) playerCount = MAX_INFLUENCE_PLAYERS;
+    if (falloff.radius < 0) falloff.radius = 0;
+    influence->map = map;
+    influence->playerCount = playerCount;
+    influence->falloff = falloff;
+
+    int radius = falloff.radius;
+    influence->stencil = (float*)malloc((3 * radius * radius + 3 * radius + 1) * sizeof(float));
+    influence->stencilRow = (int*)malloc((2 * radius + 1) * sizeof(int));
+    int offset = 0;
+    for (int dr = -radius; dr <= radius; dr++) {
+        influence->stencilRow[dr + radius] = offset;
+        int width = 2 * radius + 1 - abs(dr);
+        for (int k = 0; k < width; k++) {
+            int dq = stencilFirstQ(radius, dr) + k;
+            influence->stencil[offset + k] = influenceWeight(&falloff, HexLength(MakeHex(dq, dr, -dq - dr)));
+        }
+        offset += width;
+    }
+
+    for (int p = 0; p < playerCount; p++) {
+        influence->influence[p] = (float*)calloc(map->tileCount, sizeof(float));
+        influence->threat[p] = (float*)calloc(map->tileCount, sizeof(float));
+    }
+    influence->total = (float*)calloc(map->tileCount, sizeof(float));
+    influence->bandCount = (2 * map->radius + 1 + INFLUENCE_BAND_ROWS - 1) / INFLUENCE_BAND_ROWS;
+}
+
+void UnloadInfluenceMap(InfluenceMap* influence) {
+    for (int p = 0; p < MAX_INFLUENCE_PLAYERS; p++) {
+        free(influence->sources[p]);
+        free(influence->influence[p]);
+        free(influence->threat[p]);
+    }
+    free(influence->stencil);
+    free(influence->stencilRow);
+    free(influence->total);
+    *influence = (InfluenceMap){ 0 };
+}
+
+void ClearInfluenceSources(InfluenceMap* influence) {
+    for (int p = 0; p < influence->playerCount; p++) {
+        influence->sourceCount[p] = 0;
+    }
+}
+
+bool AddInfluenceSource(InfluenceMap* influence, int player, Hex position, float strength) {
+    int tileIndex = GetTileIndex(influence->map, position);
+    if (player < 0 || player >= influence->playerCount || tileIndex < 0) {
+        return false;
+    }
+    if (influence->sourceCount[player] == influence->sourceCapacity[player]) {
+        int capacity = (influence->sourceCapacity[player] > 0) ? 2 * influence->sourceCapacity[player] : 64;
+        InfluenceSource* sources = (InfluenceSource*)realloc(influence->sources[player], capacity * sizeof(InfluenceSource));
+        if (sources == NULL) {
+            return false;
+        }
+        influence->sources[player] = sources;
+        influence->sourceCapacity[player] = capacity;
+    }
+    influence->sources[player][influence->sourceCount[player]++] = (InfluenceSource){ tileIndex, strength };
+    return true;
+}
+
+// Tile index range of the rows of a band
+static void influenceBandTiles(const InfluenceMap* influence, int band, int* rFirst, int* rLast, int* first, int* last) {
+    const Map* map = influence->map;
+    *rFirst = -map->radius + band * INFLUENCE_BAND_ROWS;
+    *rLast = *rFirst + INFLUENCE_BAND_ROWS - 1;
+    if (*rLast > map->radius) *rLast = map->radius;
+
+    int qMin = 0, qMax = 0, lastRowFirst = 0;
+    GetMapRow(map, *rFirst, first, &qMin, &qMax);
+    GetMapRow(map, *rLast, &lastRowFirst, &qMin, &qMax);
+    *last = lastRowFirst + (qMax - qMin);
+}
+
+static inline void addWeightedRow(float* restrict dst, const float* restrict weights, float strength, int count) {
+    for (int k = 0; k < count; k++) dst[k] += strength * weights[k];
+}
+
+// Job item: stamps the sources of one player onto the rows of one band
+static void spreadInfluenceBand(void* userData, int worker, int first, int last) {
+    InfluenceMap* influence = (InfluenceMap*)userData;
+    const Map* map = influence->map;
+    int radius = influence->falloff.radius;
+    (void)worker;
+
+    for (int item = first; item < last; item++) {
+        int player = item % influence->playerCount;
+        int band = item / influence->playerCount;
+        int rFirst = 0, rLast = 0, tileFirst = 0, tileLast = 0;
+        influenceBandTiles(influence, band, &rFirst, &rLast, &tileFirst, &tileLast);
+
+        float* plane = influence->influence[player];
+        memset(plane + tileFirst, 0, (tileLast - tileFirst + 1) * sizeof(float));
+
+        for (int s = 0; s < influence->sourceCount[player]; s++) {
+            const InfluenceSource* source = &influence->sources[player][s];
+            Hex center = map->tiles[source->tileIndex].position;
+            int r0 = (center.r - radius > rFirst) ? center.r - radius : rFirst;
+            int r1 = (center.r + radius < rLast) ? center.r + radius : rLast;
+
+            for (int r = r0; r <= r1; r++) {
+                int dr = r - center.r;
+                int rowFirst = 0, qMin = 0, qMax = 0;
+                GetMapRow(map, r, &rowFirst, &qMin, &qMax);
+                int stencilQ = center.q + stencilFirstQ(radius, dr);
+                int q0 = (stencilQ > qMin) ? stencilQ : qMin;
+                int q1 = stencilQ + 2 * radius - abs(dr);
+                if (q1 > qMax) q1 = qMax;
+                if (q0 > q1) continue;
+
+                const float* weights = influence->stencil + influence->stencilRow[dr + radius] + (q0 - stencilQ);
+                addWeightedRow(plane + rowFirst + (q0 - qMin), weights, source->strength, q1 - q0 + 1);
+            }
+        }
+    }
+}
+
+// Job item: threat planes of one band (everyone else's influence)
+static void sumThreatBand(void* userData, int worker, int first, int last) {
+    InfluenceMap* influence = (InfluenceMap*)userData;
+    (void)worker;
+
+    for (int band = first; band < last; band++) {
+        int rFirst = 0, rLast = 0, tileFirst = 0, tileLast = 0;
+        influenceBandTiles(influence, band, &rFirst, &rLast, &tileFirst, &tileLast);
+        int count = tileLast - tileFirst + 1;
+
+        float* restrict total = influence->total + tileFirst;
+        memset(total, 0, count * sizeof(float));
+        for (int p = 0; p < influence->playerCount; p++) {
+            const float* restrict own = influence->influence[p] + tileFirst;
+            for (int k = 0; k < count; k++) total[k] += own[k];
+        }
+        for (int p = 0; p < influence->playerCount; p++) {
+            const float* restrict own = influence->influence[p] + tileFirst;
+            float* restrict threat = influence->threat[p] + tileFirst;
+            for (int k = 0; k < count; k++) threat[k] = total[k] - own[k];
+        }
+    }
+}
+
+// Recomputes all planes from the current sources
+void UpdateInfluenceMap(InfluenceMap* influence, WorkerPool* pool) {
+    RunWorkerJob(pool, spreadInfluenceBand, influence, influence->playerCount * influence->bandCount, 1);
+    RunWorkerJob(pool, sumThreatBand, influence, influence->bandCount, 1);
+}
+
+float GetInfluence(const InfluenceMap* influence, int player, int tileIndex) {
+    return influence->influence[player][tileIndex];
+}
+
+float GetThreat(const InfluenceMap* influence, int player, int tileIndex) {
+    return influence->threat[player][tileIndex];
+}
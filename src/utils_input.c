@@ -0,0 +1,231 @@
+/*
+    This is a utility file for frame-rate independent input handling in raylib.
+
+    raylib only samples input when PollInputEvents() runs (normally once per frame inside
+    EndDrawing()), and the IsMouseButtonPressed()/IsKeyPressed() helpers compare just the last
+    two samples. At low frame rates clicks therefore get quantized to frames and several clicks
+    between two frames collapse into one.
+
+    On the desktop platform the queue chains GLFW's mouse button and key callbacks (raylib's own
+    handlers still run), so every press and release is queued in the order GLFW delivers it,
+    even when both happen between two polls. Their time is the moment the poll dispatched them,
+    so PumpInputEvents() (poll + capture) is also called periodically while a long frame is
+    being built. Mouse movement and wheel are sampled by CaptureInputEvents() after each poll;
+    moves between two polls merge into one event and wheel steps are summed. Without a window
+    (headless replay) buttons and keys are sampled as well, and there a press and release
+    between two polls are merged. The simulation consumes the events in order with
+    PopInputEvent(), using the position and modifier keys recorded with each event, so input
+    handling no longer depends on how long drawing takes.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitInputQueue: Initializes an empty queue with a mouse mapping function (chains the GLFW callbacks).
+    - CaptureInputEvents: Queues every input change found by raylib's last poll.
+    - PumpInputEvents: Polls raylib, then captures the changes (use in the middle of a frame).
+    - PushInputEvent: Appends an event to the queue.
+    - PopInputEvent: Removes the oldest event from the queue.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - InputEventType: Kind of input event (mouse pressed/released/moved, wheel, key).
+    - InputEvent: Timestamped input event with mouse position and modifier keys.
+    - InputQueue: Ring buffer of pending input events plus the last sampled input state.
+*/
+
+#include <raylib.h>
+
+// raylib's desktop platform runs on GLFW; only the few entry points used here are declared
+typedef struct GLFWwindow GLFWwindow;
+typedef void (*GLFWmousebuttonfun)(GLFWwindow* window, int button, int action, int mods);
+typedef void (*GLFWkeyfun)(GLFWwindow* window, int key, int scancode, int action, int mods);
+GLFWwindow* glfwGetCurrentContext(void);
+GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmousebuttonfun callback);
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow* window, GLFWkeyfun callback);
+
+#define INPUT_GLFW_PRESS 1          // GLFW_PRESS (GLFW_RELEASE is 0, GLFW_REPEAT is 2)
+
+#define INPUT_QUEUE_CAPACITY 256    // Pending events kept between two simulation updates
+#define INPUT_MOUSE_BUTTONS 3       // Left, right and middle buttons are tracked
+
+// Modifier key flags stored with every event
+#define INPUT_MOD_SHIFT   1
+#define INPUT_MOD_CONTROL 2
+#define INPUT_MOD_ALT     4
+
+typedef enum InputEventType {
+    INPUT_MOUSE_PRESSED = 0,
+    INPUT_MOUSE_RELEASED,
+    INPUT_MOUSE_MOVED,
+    INPUT_MOUSE_WHEEL,
+    INPUT_KEY_PRESSED
+} InputEventType;
+
+typedef struct InputEvent {
+    InputEventType type;    // Kind of event
+    int code;               // Mouse button or key code (unused for moves and wheel)
+    int modifiers;          // INPUT_MOD_* flags held when the event was sampled
+    Vector2 position;       // Mouse position (mapped by the queue's mapMouse function)
+    float wheel;            // Wheel movement (INPUT_MOUSE_WHEEL only)
+    double time;            // Seconds since InitWindow() when the event was delivered or sampled
+} InputEvent;
+
+typedef struct InputQueue {
+    InputEvent events[INPUT_QUEUE_CAPACITY];    // Ring buffer storage
+    int head;                                   // Index of the oldest pending event
+    int count;                                  // Number of pending events
+    int droppedCount;                           // Events lost because the queue was full
+    Vector2 (*mapMouse)(void);                  // Returns the mouse position in game coordinates
+    bool buttonDown[INPUT_MOUSE_BUTTONS];       // Button state at the last pump
+    bool callbacks;                             // Buttons and keys arrive through GLFW callbacks
+    Vector2 lastPosition;                       // Mouse position at the last pump
+} InputQueue;
+
+bool PushInputEvent(InputQueue* queue, InputEvent event) {
+    if (queue->count == INPUT_QUEUE_CAPACITY) {
+        queue->droppedCount++;
+        return false;
+    }
+    queue->events[(queue->head + queue->count) % INPUT_QUEUE_CAPACITY] = event;
+    queue->count++;
+    return true;
+}
+
+bool PopInputEvent(InputQueue* queue, InputEvent* event) {
+    if (queue->count == 0) {
+        return false;
+    }
+    *event = queue->events[queue->head];
+    queue->head = (queue->head + 1) % INPUT_QUEUE_CAPACITY;
+    queue->count--;
+    return true;
+}
+
+// Queue fed by the GLFW callbacks, and raylib's handlers they forward to
+static InputQueue* callbackQueue = NULL;
+static GLFWmousebuttonfun raylibMouseButtonCallback = NULL;
+static GLFWkeyfun raylibKeyCallback = NULL;
+
+static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    if (raylibMouseButtonCallback != NULL) raylibMouseButtonCallback(window, button, action, mods);
+
+    // raylib's handler has run, so the position read here is the one at the click
+    InputQueue* queue = callbackQueue;
+    if (queue == NULL || button < 0 || button >= INPUT_MOUSE_BUTTONS) return;
+    bool down = (action == INPUT_GLFW_PRESS);
+    if (down == queue->buttonDown[button]) return;
+
+    InputEvent event = { 0 };
+    event.type = down ? INPUT_MOUSE_PRESSED : INPUT_MOUSE_RELEASED;
+    event.code = button;
+    event.time = GetTime();
+    event.modifiers = mods & (INPUT_MOD_SHIFT | INPUT_MOD_CONTROL | INPUT_MOD_ALT);  // Same bits as GLFW_MOD_*
+    event.position = (queue->mapMouse != NULL) ? queue->mapMouse() : GetMousePosition();
+    PushInputEvent(queue, event);
+    queue->buttonDown[button] = down;
+    queue->lastPosition = event.position;
+}
+
+static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (raylibKeyCallback != NULL) raylibKeyCallback(window, key, scancode, action, mods);
+
+    // Repeats are not presses, matching raylib's GetKeyPressed()
+    InputQueue* queue = callbackQueue;
+    if (queue == NULL || key < 0 || action != INPUT_GLFW_PRESS) return;
+
+    InputEvent event = { 0 };
+    event.type = INPUT_KEY_PRESSED;
+    event.code = key;   // raylib's KeyboardKey values are GLFW key codes
+    event.time = GetTime();
+    event.modifiers = mods & (INPUT_MOD_SHIFT | INPUT_MOD_CONTROL | INPUT_MOD_ALT);
+    event.position = (queue->mapMouse != NULL) ? queue->mapMouse() : GetMousePosition();
+    PushInputEvent(queue, event);
+}
+
+void InitInputQueue(InputQueue* queue, Vector2 (*mapMouse)(void)) {
+    queue->head = 0;
+    queue->count = 0;
+    queue->droppedCount = 0;
+    queue->mapMouse = mapMouse;
+    for (int b = 0; b < INPUT_MOUSE_BUTTONS; b++) {
+        queue->buttonDown[b] = false;
+    }
+    queue->lastPosition = (Vector2){ 0, 0 };
+
+    // Chain the callbacks once per window; a later queue takes them over
+    queue->callbacks = false;
+    GLFWwindow* window = IsWindowReady() ? glfwGetCurrentContext() : NULL;
+    if (window != NULL) {
+        if (callbackQueue == NULL) {
+            raylibMouseButtonCallback = glfwSetMouseButtonCallback(window, mouseButtonCallback);
+            raylibKeyCallback = glfwSetKeyCallback(window, keyCallback);
+        }
+        callbackQueue = queue;
+        queue->callbacks = true;
+    }
+}
+
+static int currentModifiers(void) {
+    int modifiers = 0;
+    if (IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT)) modifiers |= INPUT_MOD_SHIFT;
+    if (IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL)) modifiers |= INPUT_MOD_CONTROL;
+    if (IsKeyDown(KEY_LEFT_ALT) || IsKeyDown(KEY_RIGHT_ALT)) modifiers |= INPUT_MOD_ALT;
+    return modifiers;
+}
+
+// Every raylib poll must be followed by exactly one capture: wheel movement and the key
+// press queue only survive until the next poll, and reading them twice would duplicate events.
+void CaptureInputEvents(InputQueue* queue) {
+    InputEvent event = { 0 };
+    event.time = GetTime();
+    event.modifiers = currentModifiers();
+    event.position = (queue->mapMouse != NULL) ? queue->mapMouse() : GetMousePosition();
+
+    // Movement first, so button events below happen at the new position
+    if (event.position.x != queue->lastPosition.x || event.position.y != queue->lastPosition.y) {
+        event.type = INPUT_MOUSE_MOVED;
+        PushInputEvent(queue, event);
+        queue->lastPosition = event.position;
+    }
+
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        event.type = INPUT_MOUSE_WHEEL;
+        event.wheel = wheel;
+        PushInputEvent(queue, event);
+        event.wheel = 0.0f;
+    }
+
+    // Buttons and keys were queued by the callbacks while raylib polled
+    if (queue->callbacks) {
+        return;
+    }
+
+    for (int button = 0; button < INPUT_MOUSE_BUTTONS; button++) {
+        bool down = IsMouseButtonDown(button);
+        if (down != queue->buttonDown[button]) {
+            event.type = down ? INPUT_MOUSE_PRESSED : INPUT_MOUSE_RELEASED;
+            event.code = button;
+            PushInputEvent(queue, event);
+            queue->buttonDown[button] = down;
+        }
+    }
+
+    // raylib keeps its own queue of key presses, but only until the next poll
+    int key = GetKeyPressed();
+    while (key != 0) {
+        event.type = INPUT_KEY_PRESSED;
+        event.code = key;
+        PushInputEvent(queue, event);
+        key = GetKeyPressed();
+    }
+}
+
+// NOTE: Polls outside of EndDrawing(), so raylib's own Is*Pressed()/GetMouseDelta() helpers
+// only see the changes since the last pump; consume input through the queue instead.
+void PumpInputEvents(InputQueue* queue) {
+    if (!IsWindowReady()) {
+        return;     // Headless: there is nothing to poll
+    }
+    PollInputEvents();
+    CaptureInputEvents(queue);
+}
@@ -0,0 +1,137 @@
+/*
+    This is a utility file for the movement range of a unit: every hex it can reach with its
+    movement points, taking terrain costs into account.
+
+    The range is a Dijkstra search from the unit's hex that stops at the movement point
+    budget (ExpandPathCosts() with maxCost), overlay edges included. The tiles the search
+    reached are copied, in the order it reached them, into two reusable buffers: a per-tile
+    cost plane and the list of reachable tiles. Before a new range is written, only the tiles
+    of the previous one are reset, so updates cost in proportion to the range, not the map.
+
+    A range is cached for its origin, movement points and profile. It listens to map changes
+    and is only invalidated by tiles it reached or that border on it (through a side or an
+    overlay edge); while the unit stays selected and nothing nearby changes,
+    UpdateMovementRange() does no work.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitMovementRange: Allocates the range buffers for a map.
+    - UnloadMovementRange: Frees the buffers and unregisters from the map.
+    - UpdateMovementRange: Recomputes the range if its origin, budget, profile or terrain changed.
+    - ClearMovementRange: Empties the range (e.g. when the unit is deselected).
+    - GetMovementCost: Returns the cost of reaching a tile, -1 if it is out of range.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - MovementRange: Cost plane, reachable tile list and the cache key.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct MovementRange {
+    Map* map;
+    int* cost;              // Per tile: cost of reaching it, -1 if out of range
+    int* tiles;             // Reachable tiles (origin included), cheapest first
+    int count;
+
+    // Cache key of the current range
+    int origin;             // Origin tile index, -1 if there is no range
+    int movePoints;
+    PathProfile profile;
+    bool valid;             // False once a map change may have altered the range
+} MovementRange;
+
+// A change matters if the range reached the tile or one of its neighbours (for overlay
+// changes the listed tiles are the two ends of the edge)
+static bool movementRangeDependsOn(const Map* map, const MovementRange* range, int tileIndex) {
+    if (range->cost[tileIndex] >= 0) {
+        return true;
+    }
+    Hex hex = map->tiles[tileIndex].position;
+    for (int dir = 0; dir < 6; dir++) {
+        int neighbor = GetTileIndex(map, HexNeighbor(hex, dir));
+        if (neighbor >= 0 && range->cost[neighbor] >= 0) return true;
+    }
+    for (int e = FirstOverlayEdgeTo(map, tileIndex); e >= 0; e = map->overlayEdges[e].nextIn) {
+        if (range->cost[map->overlayEdges[e].from] >= 0) return true;
+    }
+    return false;
+}
+
+static void onMovementMapChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    MovementRange* range = (MovementRange*)userData;
+    (void)kind;
+    for (int i = 0; i < count && range->valid; i++) {
+        if (movementRangeDependsOn(map, range, tileIndices[i])) range->valid = false;
+    }
+}
+
+void InitMovementRange(MovementRange* range, Map* map) {
+    *range = (MovementRange){ 0 };
+    range->map = map;
+    range->cost = (int*)malloc(map->tileCount * sizeof(int));
+    range->tiles = (int*)malloc(map->tileCount * sizeof(int));
+    range->origin = -1;
+    for (int i = 0; i < map->tileCount; i++) range->cost[i] = -1;
+    AddMapChangeListener(map, onMovementMapChanged, range);
+}
+
+void UnloadMovementRange(MovementRange* range) {
+    if (range->map == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(range->map, onMovementMapChanged, range);
+    free(range->cost);
+    free(range->tiles);
+    *range = (MovementRange){ 0 };
+}
+
+void ClearMovementRange(MovementRange* range) {
+    for (int k = 0; k < range->count; k++) range->cost[range->tiles[k]] = -1;
+    range->count = 0;
+    range->origin = -1;
+    range->valid = false;
+}
+
+// Makes the range that of a unit at origin with movePoints to spend (origin outside the map:
+// no range). Does nothing if the cached range already matches; otherwise runs a bounded
+// Dijkstra with scratch. Returns true if the range was recomputed.
+bool UpdateMovementRange(MovementRange* range, PathScratch* scratch, const PathProfile* profile, Hex origin, int movePoints) {
+    const Map* map = range->map;
+    int originIndex = GetTileIndex(map, origin);
+    if (range->valid && originIndex == range->origin && movePoints == range->movePoints &&
+        memcmp(profile, &range->profile, sizeof(PathProfile)) == 0) {
+        return false;
+    }
+
+    ClearMovementRange(range);
+    range->origin = originIndex;
+    range->movePoints = movePoints;
+    range->profile = *profile;
+    range->valid = true;
+    if (originIndex < 0) {
+        return true;
+    }
+
+    if (movePoints <= 0) {
+        range->cost[originIndex] = 0;
+        range->tiles[range->count++] = originIndex;
+        return true;
+    }
+
+    // Every tile the bounded search expanded is within the budget
+    int reached = ExpandPathCosts(scratch, map, profile, origin, NULL, false, movePoints);
+    for (int k = 0; k < reached; k++) {
+        int index = scratch->expandedTiles[k];
+        range->cost[index] = GetExpandedPathCost(scratch, index);
+        range->tiles[range->count++] = index;
+    }
+    return true;
+}
+
+// Cost of reaching a tile within the current range, -1 if it cannot be reached
+int GetMovementCost(const MovementRange* range, int tileIndex) {
+    return range->cost[tileIndex];
+}
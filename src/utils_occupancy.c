@@ -0,0 +1,180 @@
+/*
+    This is a utility file for finding the entities on a hex: an occupancy index from tile
+    index to the entities standing there.
+
+    Every tile has the head of a doubly linked list of entities, and the links live in arrays
+    indexed by the slot of the entity handle (intrusive lists: no nodes are allocated, each
+    entity is in at most one list). Placing, moving and removing an entity is O(1), and so are "how many entities
+    are on this hex" and walking them. Area queries walk the hexagon around a center row by
+    row with GetMapRow(), so they visit the tiles in range and the entities on them, never the
+    whole entity list.
+
+    The index does not know where entities are by itself; whoever moves them (e.g. a movement
+    system) calls PlaceOccupant() with the new tile. Every slot remembers the handle placed
+    there, so a stale handle is never mistaken for the entity that reuses its slot, and
+    placing that entity unlinks whatever was left in the slot.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitOccupancyIndex: Allocates the per-tile list heads for a map.
+    - UnloadOccupancyIndex: Frees the index.
+    - PlaceOccupant: Puts an entity on a tile, moving it if it is on another one.
+    - RemoveOccupant: Takes an entity off its tile.
+    - GetOccupantTile: Returns the tile of an entity, -1 if it is not placed.
+    - GetOccupantCount: Returns the number of entities on a tile.
+    - FirstOccupant / NextOccupant: Walk the entities on a tile.
+    - QueryOccupantsInRange: Collects the entities within a distance of a hex.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - OccupancyIndex: Per-tile list heads and counts, per-slot links, handles and tiles.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+typedef struct OccupancyIndex {
+    const Map* map;
+    Entity* head;           // Per tile: first entity, ECS_NO_ENTITY if empty
+    int* count;             // Per tile: entities on it
+    Entity* next;           // Per handle slot: next / previous entity on the same tile
+    Entity* prev;
+    Entity* occupant;       // Per handle slot: entity placed from it
+    int* tile;              // Per handle slot: tile of the occupant, -1 if not placed
+    int capacity;           // Handle slots the arrays cover
+} OccupancyIndex;
+
+void InitOccupancyIndex(OccupancyIndex* index, const Map* map) {
+    *index = (OccupancyIndex){ 0 };
+    index->map = map;
+    index->head = (Entity*)malloc(map->tileCount * sizeof(Entity));
+    index->count = (int*)calloc(map->tileCount, sizeof(int));
+    for (int i = 0; i < map->tileCount; i++) index->head[i] = ECS_NO_ENTITY;
+}
+
+void UnloadOccupancyIndex(OccupancyIndex* index) {
+    free(index->head);
+    free(index->count);
+    free(index->next);
+    free(index->prev);
+    free(index->occupant);
+    free(index->tile);
+    *index = (OccupancyIndex){ 0 };
+}
+
+// Makes the slot arrays cover a handle slot
+static bool growOccupancyIndex(OccupancyIndex* index, int slot) {
+    if (slot < index->capacity) {
+        return true;
+    }
+    int capacity = (index->capacity > 0) ? index->capacity : 1024;
+    while (capacity <= slot) capacity *= 2;
+    Entity* next = (Entity*)realloc(index->next, capacity * sizeof(Entity));
+    if (next != NULL) index->next = next;
+    Entity* prev = (Entity*)realloc(index->prev, capacity * sizeof(Entity));
+    if (prev != NULL) index->prev = prev;
+    Entity* occupant = (Entity*)realloc(index->occupant, capacity * sizeof(Entity));
+    if (occupant != NULL) index->occupant = occupant;
+    int* tile = (int*)realloc(index->tile, capacity * sizeof(int));
+    if (tile != NULL) index->tile = tile;
+    if (next == NULL || prev == NULL || occupant == NULL || tile == NULL) {
+        return false;
+    }
+    for (int e = index->capacity; e < capacity; e++) index->tile[e] = -1;
+    index->capacity = capacity;
+    return true;
+}
+
+// Tile of an entity, -1 if it is not placed (or the handle is stale)
+int GetOccupantTile(const OccupancyIndex* index, Entity entity) {
+    int slot = GetHandleIndex(entity);
+    return (slot < index->capacity && index->occupant[slot] == entity) ? index->tile[slot] : -1;
+}
+
+// Unlinks whatever occupies a handle slot
+static void unlinkOccupantSlot(OccupancyIndex* index, int slot) {
+    int tile = index->tile[slot];
+    if (tile < 0) {
+        return;
+    }
+    Entity next = index->next[slot];
+    Entity prev = index->prev[slot];
+    if (prev != ECS_NO_ENTITY) index->next[GetHandleIndex(prev)] = next;
+    else index->head[tile] = next;
+    if (next != ECS_NO_ENTITY) index->prev[GetHandleIndex(next)] = prev;
+    index->count[tile]--;
+    index->tile[slot] = -1;
+}
+
+void RemoveOccupant(OccupancyIndex* index, Entity entity) {
+    if (GetOccupantTile(index, entity) >= 0) unlinkOccupantSlot(index, GetHandleIndex(entity));
+}
+
+// Puts an entity on a tile (at the front of its list), taking it off the tile it was on.
+// A tile outside [0, tileCount) removes it. Returns false if out of memory.
+bool PlaceOccupant(OccupancyIndex* index, Entity entity, int tile) {
+    int slot = GetHandleIndex(entity);
+    if (entity == ECS_NO_ENTITY || !growOccupancyIndex(index, slot)) {
+        return false;
+    }
+    if (index->occupant[slot] == entity && index->tile[slot] == tile) {
+        return true;
+    }
+    unlinkOccupantSlot(index, slot);
+    if (tile < 0 || tile >= index->map->tileCount) {
+        return true;
+    }
+    Entity first = index->head[tile];
+    index->next[slot] = first;
+    index->prev[slot] = ECS_NO_ENTITY;
+    if (first != ECS_NO_ENTITY) index->prev[GetHandleIndex(first)] = entity;
+    index->head[tile] = entity;
+    index->count[tile]++;
+    index->occupant[slot] = entity;
+    index->tile[slot] = tile;
+    return true;
+}
+
+int GetOccupantCount(const OccupancyIndex* index, int tile) {
+    return index->count[tile];
+}
+
+// for (Entity e = FirstOccupant(index, tile); e != ECS_NO_ENTITY; e = NextOccupant(index, e))
+Entity FirstOccupant(const OccupancyIndex* index, int tile) {
+    return index->head[tile];
+}
+
+Entity NextOccupant(const OccupancyIndex* index, Entity entity) {
+    return index->next[GetHandleIndex(entity)];
+}
+
+// Writes up to maxCount entities within radius of center to entities (NULL to only count
+// them), tile by tile in row order. Returns the number of entities in range, which may
+// exceed maxCount.
+int QueryOccupantsInRange(const OccupancyIndex* index, Hex center, int radius, Entity* entities, int maxCount) {
+    const Map* map = index->map;
+    int found = 0;
+    int r0 = (center.r - radius > -map->radius) ? center.r - radius : -map->radius;
+    int r1 = (center.r + radius < map->radius) ? center.r + radius : map->radius;
+    for (int r = r0; r <= r1; r++) {
+        // Row r of the hexagon around center covers q in [qFrom, qTo]
+        int dr = r - center.r;
+        int qFrom = center.q - radius - ((dr < 0) ? dr : 0);
+        int qTo = center.q + radius - ((dr > 0) ? dr : 0);
+        int rowFirst = 0, qMin = 0, qMax = 0;
+        GetMapRow(map, r, &rowFirst, &qMin, &qMax);
+        if (qFrom < qMin) qFrom = qMin;
+        if (qTo > qMax) qTo = qMax;
+
+        for (int tile = rowFirst + (qFrom - qMin); tile <= rowFirst + (qTo - qMin); tile++) {
+            if (entities != NULL) {
+                int written = found;
+                for (Entity e = index->head[tile]; e != ECS_NO_ENTITY && written < maxCount; e = index->next[GetHandleIndex(e)]) {
+                    entities[written++] = e;
+                }
+            }
+            found += index->count[tile];
+        }
+    }
+    return found;
+}
@@ -0,0 +1,181 @@
+/*
+    This is a utility file for solving many path queries at once on a worker pool.
+
+    End-of-turn movement needs a path for every AI fleet. FindPathBatch() hands the queries to
+    the workers of a WorkerPool (utils_workers.c); every worker searches with its own
+    PathScratch and appends the paths it finds to its own tile buffer, so workers share
+    nothing but the read-only map. Once all queries are done the paths are gathered into one
+    array in query order.
+
+    Each query is an ordinary FindPath() search whose result depends only on the query and
+    the map, so the results are identical for any number of threads. The map must not change
+    during the call; code that edits the map from other threads should hand the batch a
+    snapshot made with CloneMap().
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - CreatePathBatch: Creates the per-worker search state for a map.
+    - DestroyPathBatch: Frees the batch state and results.
+    - FindPathBatch: Solves a list of path queries on a worker pool.
+    - GetBatchPath: Returns the tiles of one solved query.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - PathQuery: Start and goal of one query.
+    - PathResult: Length, cost and position of one solved path.
+    - PathBatch: Per-worker scratch and tile buffers, results and gathered paths.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PATH_BATCH_CHUNK 4      // Queries handed to a worker at a time
+
+typedef struct PathQuery {
+    Hex start;
+    Hex goal;
+} PathQuery;
+
+typedef struct PathResult {
+    int length;         // Tiles on the path, 0 if the goal is unreachable
+    int cost;           // Total path cost
+    int first;          // Index of the first path tile in the batch tile array
+} PathResult;
+
+typedef struct PathBatchWorker {
+    PathScratch scratch;
+    int* tiles;         // Paths found by this worker, in the order it solved them
+    int tileCount;
+    int tileCapacity;
+    bool failed;        // A tile buffer could not grow during the last batch
+} PathBatchWorker;
+
+typedef struct PathBatch {
+    const Map* map;
+    PathBatchWorker workers[MAX_WORKERS];
+    PathResult* results;        // One per query of the last batch
+    int* resultWorker;          // Worker that solved each query
+    int resultCapacity;
+    int* tiles;                 // All paths of the last batch, in query order
+    int tileCount;
+    int tileCapacity;
+
+    // Job inputs of the running batch
+    const PathProfile* profile;
+    const PathQuery* queries;
+} PathBatch;
+
+PathBatch CreatePathBatch(const Map* map) {
+    PathBatch batch = { 0 };
+    batch.map = map;
+    return batch;
+}
+
+void DestroyPathBatch(PathBatch* batch) {
+    for (int w = 0; w < MAX_WORKERS; w++) {
+        DestroyPathScratch(&batch->workers[w].scratch);
+        free(batch->workers[w].tiles);
+    }
+    free(batch->results);
+    free(batch->resultWorker);
+    free(batch->tiles);
+    *batch = (PathBatch){ 0 };
+}
+
+static bool growPathBuffer(int** buffer, int* capacity, int needed) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    int newCapacity = (*capacity > 0) ? *capacity : 1024;
+    while (newCapacity < needed) newCapacity *= 2;
+    int* grown = (int*)realloc(*buffer, newCapacity * sizeof(int));
+    if (grown == NULL) {
+        return false;
+    }
+    *buffer = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static void solvePathQueries(void* userData, int worker, int first, int last) {
+    PathBatch* batch = (PathBatch*)userData;
+    PathBatchWorker* state = &batch->workers[worker];
+    const Map* map = batch->map;
+
+    for (int i = first; i < last; i++) {
+        PathResult* result = &batch->results[i];
+        batch->resultWorker[i] = worker;
+        result->cost = 0;
+        result->first = state->tileCount;
+        result->length = FindPath(&state->scratch, map, batch->profile, batch->queries[i].start, batch->queries[i].goal, NULL, 0, &result->cost);
+        if (result->length == 0) continue;
+
+        if (!growPathBuffer(&state->tiles, &state->tileCapacity, state->tileCount + result->length)) {
+            state->failed = true;
+            result->length = 0;
+            continue;
+        }
+        writeFoundPath(&state->scratch, GetTileIndex(map, batch->queries[i].goal), state->tiles + state->tileCount, result->length);
+        state->tileCount += result->length;
+    }
+}
+
+// Solves count queries with the workers of pool and stores the results in the batch (see
+// GetBatchPath()). Returns the number of queries whose goal was reached, or -1 if the
+// results could not be stored.
+int FindPathBatch(PathBatch* batch, WorkerPool* pool, const PathProfile* profile, const PathQuery* queries, int count) {
+    if (count > batch->resultCapacity) {
+        PathResult* results = (PathResult*)realloc(batch->results, count * sizeof(PathResult));
+        if (results != NULL) batch->results = results;
+        int* resultWorker = (int*)realloc(batch->resultWorker, count * sizeof(int));
+        if (resultWorker != NULL) batch->resultWorker = resultWorker;
+        if (results == NULL || resultWorker == NULL) {
+            return -1;
+        }
+        batch->resultCapacity = count;
+    }
+
+    // Scratch is created on first use, so a batch never allocates more than the pool uses
+    for (int w = 0; w < GetWorkerCount(pool); w++) {
+        PathBatchWorker* state = &batch->workers[w];
+        if (state->scratch.stamp == NULL) state->scratch = CreatePathScratch(batch->map);
+        state->tileCount = 0;
+        state->failed = false;
+    }
+
+    batch->profile = profile;
+    batch->queries = queries;
+    RunWorkerJob(pool, solvePathQueries, batch, count, PATH_BATCH_CHUNK);
+
+    // Gather the paths in query order
+    int total = 0;
+    for (int w = 0; w < GetWorkerCount(pool); w++) {
+        if (batch->workers[w].failed) return -1;
+        total += batch->workers[w].tileCount;
+    }
+    if (!growPathBuffer(&batch->tiles, &batch->tileCapacity, total)) {
+        return -1;
+    }
+
+    int reached = 0;
+    batch->tileCount = 0;
+    for (int i = 0; i < count; i++) {
+        PathResult* result = &batch->results[i];
+        if (result->length > 0) {
+            const int* source = batch->workers[batch->resultWorker[i]].tiles + result->first;
+            memcpy(batch->tiles + batch->tileCount, source, result->length * sizeof(int));
+            reached++;
+        }
+        result->first = batch->tileCount;
+        batch->tileCount += result->length;
+    }
+    return reached;
+}
+
+// Tiles of query i of the last batch (start first, goal last); length is set to 0 if the
+// goal was unreachable
+const int* GetBatchPath(const PathBatch* batch, int i, int* length) {
+    *length = batch->results[i].length;
+    return batch->tiles + batch->results[i].first;
+}
@@ -0,0 +1,234 @@
+/*
+    This is a utility file for caching path queries on a hex map.
+
+    AI and UI code ask for the same (start, goal, profile) paths over and over. The cache keeps
+    the results of recent FindPath() queries in a hash table and answers repeated queries
+    without searching. Paths are stored compactly as one step code byte per step (a direction,
+    or an overlay edge of the tile, see encodePathStep()), and unreachable goals are cached too.
+
+    Every entry records the region its result depends on: the box of the tiles the search
+    expanded (and the ends of the overlay edges it looked across), grown by one tile so that
+    it also covers every tile the search looked at. A terrain change outside that region
+    cannot change what A* would return, so the cache listens to map changes and only drops
+    the entries whose region contains a changed tile; everything else stays valid and keeps
+    returning exactly what a fresh search would. Overlay edge changes alter the A* heuristic
+    everywhere and clear the whole cache.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitPathCache: Creates an empty cache for a map.
+    - UnloadPathCache: Frees the cache and unregisters it from the map.
+    - FindPathCached: Same as FindPath, answered from the cache when possible.
+    - ClearPathCache: Drops every cached path.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - PathCacheEntry: Query key, compact path and dependency region of one cached result.
+    - PathCache: Entry pool, hash buckets and hit statistics.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PATH_CACHE_SIZE 256         // Cached queries at most
+#define PATH_CACHE_BUCKETS 512      // Hash buckets (power of two)
+
+typedef struct PathCacheEntry {
+    int start;                  // Start tile index, -1 for a free entry
+    int goal;                   // Goal tile index
+    PathProfile profile;        // Terrain costs the path was searched with
+    int length;                 // Tiles on the path, 0 if the goal is unreachable
+    int cost;                   // Total path cost
+    unsigned char* steps;       // length - 1 step codes from the start
+    int stepCapacity;
+    PathBounds depends;         // Tiles whose terrain the result depends on
+    unsigned int lastUse;       // Cache clock value of the last hit (LRU order)
+    int next;                   // Next entry in the same bucket, -1 at the end
+} PathCacheEntry;
+
+typedef struct PathCache {
+    Map* map;
+    PathCacheEntry entries[PATH_CACHE_SIZE];
+    int buckets[PATH_CACHE_BUCKETS];    // First entry of each bucket, -1 if empty
+    unsigned int clock;
+    int hits;
+    int misses;
+} PathCache;
+
+static unsigned int pathCacheHash(int start, int goal, const PathProfile* profile) {
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ (unsigned int)start) * 16777619u;
+    hash = (hash ^ (unsigned int)goal) * 16777619u;
+    for (int t = 0; t < TILE_TYPE_COUNT; t++) hash = (hash ^ (unsigned int)profile->terrainCost[t]) * 16777619u;
+    return hash & (PATH_CACHE_BUCKETS - 1);
+}
+
+static void unlinkPathCacheEntry(PathCache* cache, int slot) {
+    PathCacheEntry* entry = &cache->entries[slot];
+    int* link = &cache->buckets[pathCacheHash(entry->start, entry->goal, &entry->profile)];
+    while (*link != slot) link = &cache->entries[*link].next;
+    *link = entry->next;
+    entry->start = -1;
+}
+
+void ClearPathCache(PathCache* cache) {
+    for (int e = 0; e < PATH_CACHE_SIZE; e++) {
+        cache->entries[e].start = -1;
+    }
+    for (int b = 0; b < PATH_CACHE_BUCKETS; b++) {
+        cache->buckets[b] = -1;
+    }
+}
+
+static void onPathCacheMapChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    PathCache* cache = (PathCache*)userData;
+    if (kind == MAP_CHANGE_OVERLAY) {
+        ClearPathCache(cache);
+        return;
+    }
+
+    // Box of the whole batch first, so unrelated entries are skipped with one test
+    Hex first = map->tiles[tileIndices[0]].position;
+    PathBounds changed = { first.q, first.q, first.r, first.r };
+    for (int i = 1; i < count; i++) {
+        Hex hex = map->tiles[tileIndices[i]].position;
+        if (hex.q < changed.qMin) changed.qMin = hex.q;
+        if (hex.q > changed.qMax) changed.qMax = hex.q;
+        if (hex.r < changed.rMin) changed.rMin = hex.r;
+        if (hex.r > changed.rMax) changed.rMax = hex.r;
+    }
+
+    for (int e = 0; e < PATH_CACHE_SIZE; e++) {
+        PathCacheEntry* entry = &cache->entries[e];
+        if (entry->start < 0) continue;
+        const PathBounds* depends = &entry->depends;
+        if (changed.qMax < depends->qMin || changed.qMin > depends->qMax || changed.rMax < depends->rMin || changed.rMin > depends->rMax) continue;
+
+        for (int i = 0; i < count; i++) {
+            if (isInPathBounds(depends, map->tiles[tileIndices[i]].position)) {
+                unlinkPathCacheEntry(cache, e);
+                break;
+            }
+        }
+    }
+}
+
+void InitPathCache(PathCache* cache, Map* map) {
+    *cache = (PathCache){ 0 };
+    cache->map = map;
+    ClearPathCache(cache);
+    AddMapChangeListener(map, onPathCacheMapChanged, cache);
+}
+
+void UnloadPathCache(PathCache* cache) {
+    if (cache->map == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(cache->map, onPathCacheMapChanged, cache);
+    for (int e = 0; e < PATH_CACHE_SIZE; e++) {
+        free(cache->entries[e].steps);
+    }
+    *cache = (PathCache){ 0 };
+}
+
+// Free entry if there is one, otherwise the least recently used one
+static int takePathCacheEntry(PathCache* cache) {
+    int slot = 0;
+    for (int e = 0; e < PATH_CACHE_SIZE; e++) {
+        if (cache->entries[e].start < 0) return e;
+        if (cache->entries[e].lastUse < cache->entries[slot].lastUse) slot = e;
+    }
+    unlinkPathCacheEntry(cache, slot);
+    return slot;
+}
+
+// Stores the result of the search that just ran in scratch
+static bool storePathCacheEntry(PathCache* cache, const PathScratch* scratch, PathCacheEntry* entry, int length) {
+    const Map* map = cache->map;
+    if (length - 1 > entry->stepCapacity) {
+        unsigned char* steps = (unsigned char*)realloc(entry->steps, (length - 1) * sizeof(unsigned char));
+        if (steps == NULL) {
+            return false;
+        }
+        entry->steps = steps;
+        entry->stepCapacity = length - 1;
+    }
+
+    // Walk back from the goal, writing the code of every step into its slot
+    int k = length - 1;
+    for (int t = entry->goal; k > 0; t = scratch->parent[t]) {
+        int parent = scratch->parent[t];
+        entry->steps[--k] = (unsigned char)encodePathStep(map, parent, t, scratch->g[t] - scratch->g[parent]);
+    }
+    return true;
+}
+
+// Same contract as FindPath(). Repeated queries with the same start, goal and profile are
+// answered from the cache (unreachable goals included) until a terrain change inside the
+// region the search depended on, or any overlay edge change, drops them. scratch is only used on a cache miss.
+int FindPathCached(PathCache* cache, PathScratch* scratch, const PathProfile* profile, Hex start, Hex goal, int* path, int maxPath, int* totalCost) {
+    const Map* map = cache->map;
+    int startIndex = GetTileIndex(map, start);
+    int goalIndex = GetTileIndex(map, goal);
+    if (startIndex < 0 || goalIndex < 0) {
+        return 0;
+    }
+
+    cache->clock++;
+    unsigned int bucket = pathCacheHash(startIndex, goalIndex, profile);
+    PathCacheEntry* entry = NULL;
+    for (int e = cache->buckets[bucket]; e >= 0; e = cache->entries[e].next) {
+        PathCacheEntry* candidate = &cache->entries[e];
+        if (candidate->start == startIndex && candidate->goal == goalIndex &&
+            memcmp(&candidate->profile, profile, sizeof(PathProfile)) == 0) {
+            entry = candidate;
+            break;
+        }
+    }
+
+    if (entry != NULL) {
+        cache->hits++;
+    }
+    else {
+        cache->misses++;
+        int cost = 0;
+        int length = FindPath(scratch, map, profile, start, goal, NULL, 0, &cost);
+
+        int slot = takePathCacheEntry(cache);
+        entry = &cache->entries[slot];
+        entry->start = startIndex;
+        entry->goal = goalIndex;
+        entry->profile = *profile;
+        entry->length = length;
+        entry->cost = cost;
+        if (length > 1 && !storePathCacheEntry(cache, scratch, entry, length)) {
+            entry->start = -1;
+            return FindPath(scratch, map, profile, start, goal, path, maxPath, totalCost);
+        }
+
+        // Expanded tiles plus everything adjacent to them (axial neighbours are within +-1);
+        // a goal that cannot be entered is rejected without searching
+        entry->depends = scratch->explored;
+        if (startIndex != goalIndex && GetPathStepCost(map, profile, goalIndex) == PATH_COST_BLOCKED) {
+            entry->depends = (PathBounds){ goal.q, goal.q, goal.r, goal.r };
+        }
+        entry->depends.qMin--;
+        entry->depends.qMax++;
+        entry->depends.rMin--;
+        entry->depends.rMax++;
+
+        entry->next = cache->buckets[bucket];
+        cache->buckets[bucket] = slot;
+    }
+    entry->lastUse = cache->clock;
+
+    if (entry->length > 0 && totalCost != NULL) *totalCost = entry->cost;
+    if (path != NULL && entry->length > 0 && entry->length <= maxPath) {
+        path[0] = startIndex;
+        for (int k = 1; k < entry->length; k++) {
+            path[k] = decodePathStep(map, path[k - 1], entry->steps[k - 1]);
+        }
+    }
+    return entry->length;
+}
@@ -0,0 +1,391 @@
+/*
+    This is a utility file for finding shortest paths on a hex map (A* search).
+
+    Movement cost is per terrain type (PathProfile); a tile can be entered if it is walkable
+    and its terrain has a positive cost. Overlay edges of the map (hyperlanes, wormholes) are
+    followed like extra neighbours at their own cost. The heuristic is HexDistance() times the
+    cheapest terrain cost of the profile, capped by the cheapest conceivable route through an
+    overlay edge (cheapest edge cost plus the distance from the nearest edge exit to the goal),
+    so it never overestimates even when a wormhole skips half the map, and returned paths are
+    optimal.
+
+    All per-tile search state lives in a PathScratch that is allocated once per map and reused
+    by every query: a search stamp marks which entries belong to the current query, so nothing
+    is cleared or allocated between searches. The open set is an indexed binary heap (each
+    tile knows its heap slot), so a cheaper route to a tile already in the open set moves it up
+    in place instead of adding a duplicate entry. A scratch must not be shared between threads;
+    the map is only read.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - DefaultPathProfile: Returns the default terrain costs.
+    - GetPathStepCost: Returns the cost of entering a tile (0 if it cannot be entered).
+    - CreatePathScratch: Allocates the reusable search state for a map.
+    - DestroyPathScratch: Frees the memory allocated for the search state.
+    - FindPath: Finds the cheapest path between two hexes.
+    - FindPathInBounds: Same as FindPath, restricted to an axial coordinate box.
+    - ExpandPathCosts: Computes the cost from (or to) one hex for every reachable tile (Dijkstra).
+    - GetExpandedPathCost: Reads a tile cost computed by ExpandPathCosts.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - PathProfile: Cost of entering each terrain type.
+    - PathScratch: Per-tile search state and the indexed open-set heap.
+    - PathBounds: Axial coordinate box restricting a search.
+    - PathHeuristic: Admissible A* estimate towards one goal.
+*/
+
+#include <raylib.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#define PATH_COST_BLOCKED 0     // Terrain cost meaning "cannot be entered"
+#define PATH_STEP_OVERLAY 8     // Step code of the first overlay edge leaving a tile (+k: k-th edge)
+
+// Axial coordinate box a search may not leave
+typedef struct PathBounds {
+    int qMin, qMax;
+    int rMin, rMax;
+} PathBounds;
+
+typedef struct PathProfile {
+    int terrainCost[TILE_TYPE_COUNT];   // Cost of entering a tile of each type (PATH_COST_BLOCKED: never)
+} PathProfile;
+
+typedef struct PathScratch {
+    int tileCount;
+    unsigned int* stamp;    // searchId of the query that last touched the tile
+    unsigned int searchId;
+    int* g;                 // Cost from the start
+    int* f;                 // g + heuristic
+    int* parent;            // Previous tile on the best known route (-1 at the start)
+    int* heapSlot;          // Slot of the tile in the heap, -1 once closed
+    int* heap;              // Open set: tile indices ordered by (f, -g)
+    int heapSize;
+    int* waypoints;         // Abstract route of hierarchical queries (utils_hpa.c)
+    int* expandedTiles;     // Tiles in the order the last query expanded them
+    int expanded;           // Tiles expanded by the last query
+    PathBounds explored;    // Box of the tiles expanded (or looked at through overlay edges) by the last query
+} PathScratch;
+
+// Estimate of the cost left to reach goal: min(stepCost * distance, overlayBound)
+typedef struct PathHeuristic {
+    Hex goal;
+    int stepCost;           // Cheapest terrain cost, 0 for Dijkstra searches
+    int overlayBound;       // Lower bound of any route using an overlay edge, INT_MAX without edges
+} PathHeuristic;
+
+PathProfile DefaultPathProfile(void) {
+    PathProfile profile = { 0 };
+    profile.terrainCost[TILE_GRASS] = 10;
+    profile.terrainCost[TILE_WATER] = PATH_COST_BLOCKED;
+    profile.terrainCost[TILE_ROCKS] = PATH_COST_BLOCKED;
+    profile.terrainCost[TILE_SAND] = 15;
+    profile.terrainCost[TILE_FOREST] = 20;
+    return profile;
+}
+
+int GetPathStepCost(const Map* map, const PathProfile* profile, int tileIndex) {
+    const Tile* tile = &map->tiles[tileIndex];
+    return tile->isWalkable ? profile->terrainCost[tile->type] : PATH_COST_BLOCKED;
+}
+
+// Cheapest enterable terrain: scales HexDistance() into an admissible heuristic
+static int minStepCost(const PathProfile* profile) {
+    int minCost = 0;
+    for (int t = 0; t < TILE_TYPE_COUNT; t++) {
+        int cost = profile->terrainCost[t];
+        if (cost > PATH_COST_BLOCKED && (minCost == 0 || cost < minCost)) minCost = cost;
+    }
+    return minCost;
+}
+
+// Any route through an overlay edge costs at least the cheapest edge plus the walk from its
+// exit to the goal, so capping the distance estimate there keeps it admissible (and, being
+// the minimum of two consistent estimates, consistent)
+static PathHeuristic makePathHeuristic(const Map* map, const PathProfile* profile, int goalIndex) {
+    PathHeuristic heuristic = { map->tiles[goalIndex].position, minStepCost(profile), INT_MAX };
+    int minEdgeCost = INT_MAX;
+    int minExitDistance = INT_MAX;
+    for (int e = 0; e < map->overlayCapacity && map->overlayCount > 0; e++) {
+        const MapOverlayEdge* edge = &map->overlayEdges[e];
+        if (edge->from < 0) continue;
+        int distance = HexDistance(map->tiles[edge->to].position, heuristic.goal);
+        if (edge->cost < minEdgeCost) minEdgeCost = edge->cost;
+        if (distance < minExitDistance) minExitDistance = distance;
+    }
+    if (minEdgeCost < INT_MAX) heuristic.overlayBound = minEdgeCost + heuristic.stepCost * minExitDistance;
+    return heuristic;
+}
+
+static inline int pathHeuristic(const PathHeuristic* heuristic, Hex hex) {
+    int estimate = heuristic->stepCost * HexDistance(hex, heuristic->goal);
+    return (estimate < heuristic->overlayBound) ? estimate : heuristic->overlayBound;
+}
+
+// Search state for node ids [0, count): tiles, or the nodes of searches over other graphs
+// (hierarchical and space-time searches reuse the heap helpers)
+static PathScratch createPathScratchSized(int count) {
+    PathScratch scratch = { 0 };
+    scratch.tileCount = count;
+    scratch.stamp = (unsigned int*)calloc(count, sizeof(unsigned int));
+    scratch.g = (int*)malloc(count * sizeof(int));
+    scratch.f = (int*)malloc(count * sizeof(int));
+    scratch.parent = (int*)malloc(count * sizeof(int));
+    scratch.heapSlot = (int*)malloc(count * sizeof(int));
+    scratch.heap = (int*)malloc(count * sizeof(int));
+    scratch.waypoints = (int*)malloc(count * sizeof(int));
+    scratch.expandedTiles = (int*)malloc(count * sizeof(int));
+    return scratch;
+}
+
+PathScratch CreatePathScratch(const Map* map) {
+    return createPathScratchSized(map->tileCount);
+}
+
+void DestroyPathScratch(PathScratch* scratch) {
+    free(scratch->stamp);
+    free(scratch->g);
+    free(scratch->f);
+    free(scratch->parent);
+    free(scratch->heapSlot);
+    free(scratch->heap);
+    free(scratch->waypoints);
+    free(scratch->expandedTiles);
+    *scratch = (PathScratch){ 0 };
+}
+
+// Starts a query: a new stamp invalidates the state of all previous queries at once
+static void beginPathSearch(PathScratch* scratch) {
+    scratch->searchId++;
+    if (scratch->searchId == 0) {
+        for (int i = 0; i < scratch->tileCount; i++) scratch->stamp[i] = 0;
+        scratch->searchId = 1;
+    }
+    scratch->heapSize = 0;
+    scratch->expanded = 0;
+}
+
+// Heap order: lower f first, then higher g (deeper nodes first on ties)
+static inline bool heapBefore(const PathScratch* scratch, int a, int b) {
+    if (scratch->f[a] != scratch->f[b]) return scratch->f[a] < scratch->f[b];
+    return scratch->g[a] > scratch->g[b];
+}
+
+static void heapSiftUp(PathScratch* scratch, int slot) {
+    int tile = scratch->heap[slot];
+    while (slot > 0) {
+        int parentSlot = (slot - 1) / 2;
+        int parentTile = scratch->heap[parentSlot];
+        if (!heapBefore(scratch, tile, parentTile)) break;
+        scratch->heap[slot] = parentTile;
+        scratch->heapSlot[parentTile] = slot;
+        slot = parentSlot;
+    }
+    scratch->heap[slot] = tile;
+    scratch->heapSlot[tile] = slot;
+}
+
+static void heapSiftDown(PathScratch* scratch, int slot) {
+    int tile = scratch->heap[slot];
+    for (;;) {
+        int child = 2 * slot + 1;
+        if (child >= scratch->heapSize) break;
+        if (child + 1 < scratch->heapSize && heapBefore(scratch, scratch->heap[child + 1], scratch->heap[child])) child++;
+        if (!heapBefore(scratch, scratch->heap[child], tile)) break;
+        scratch->heap[slot] = scratch->heap[child];
+        scratch->heapSlot[scratch->heap[slot]] = slot;
+        slot = child;
+    }
+    scratch->heap[slot] = tile;
+    scratch->heapSlot[tile] = slot;
+}
+
+static void heapPush(PathScratch* scratch, int tile) {
+    scratch->heap[scratch->heapSize] = tile;
+    scratch->heapSize++;
+    heapSiftUp(scratch, scratch->heapSize - 1);
+}
+
+static int heapPop(PathScratch* scratch) {
+    int top = scratch->heap[0];
+    scratch->heapSize--;
+    if (scratch->heapSize > 0) {
+        scratch->heap[0] = scratch->heap[scratch->heapSize];
+        heapSiftDown(scratch, 0);
+    }
+    scratch->heapSlot[top] = -1;
+    return top;
+}
+
+// Adds or improves the route to a tile: new tiles are pushed onto the open set, open tiles
+// with a cheaper route are moved up in place, closed tiles are left alone
+static void relaxPathTile(PathScratch* scratch, int tile, int g, int h, int parent) {
+    if (scratch->stamp[tile] != scratch->searchId) {
+        scratch->stamp[tile] = scratch->searchId;
+        scratch->g[tile] = g;
+        scratch->f[tile] = g + h;
+        scratch->parent[tile] = parent;
+        heapPush(scratch, tile);
+    }
+    else if (g < scratch->g[tile] && scratch->heapSlot[tile] >= 0) {
+        scratch->f[tile] -= scratch->g[tile] - g;
+        scratch->g[tile] = g;
+        scratch->parent[tile] = parent;
+        heapSiftUp(scratch, scratch->heapSlot[tile]);
+    }
+}
+
+static inline bool isInPathBounds(const PathBounds* bounds, Hex hex) {
+    return bounds == NULL || (hex.q >= bounds->qMin && hex.q <= bounds->qMax && hex.r >= bounds->rMin && hex.r <= bounds->rMax);
+}
+
+static inline void growPathBounds(PathBounds* bounds, Hex hex) {
+    if (hex.q < bounds->qMin) bounds->qMin = hex.q;
+    if (hex.q > bounds->qMax) bounds->qMax = hex.q;
+    if (hex.r < bounds->rMin) bounds->rMin = hex.r;
+    if (hex.r > bounds->rMax) bounds->rMax = hex.r;
+}
+
+// Shared search loop: A* towards goalIndex, or Dijkstra over everything reachable when
+// goalIndex is -1. In reverse mode g is the cost of reaching the origin from the tile
+// (the cost of the tile being left is paid instead of the tile being entered, and overlay
+// edges are followed backwards). Returns true if the goal was reached (always true for
+// Dijkstra).
+static bool searchPath(PathScratch* scratch, const Map* map, const PathProfile* profile, int originIndex, int goalIndex,
+                       const PathBounds* bounds, bool reverse, int maxCost) {
+    beginPathSearch(scratch);
+    PathHeuristic heuristic = { 0 };
+    if (goalIndex >= 0) heuristic = makePathHeuristic(map, profile, goalIndex);
+    else heuristic.overlayBound = INT_MAX;
+
+    Hex origin = map->tiles[originIndex].position;
+    scratch->explored = (PathBounds){ origin.q, origin.q, origin.r, origin.r };
+    relaxPathTile(scratch, originIndex, 0, pathHeuristic(&heuristic, origin), -1);
+
+    while (scratch->heapSize > 0) {
+        int current = heapPop(scratch);
+        if (current == goalIndex) {
+            return true;
+        }
+        scratch->expandedTiles[scratch->expanded++] = current;
+
+        int leaveCost = reverse ? GetPathStepCost(map, profile, current) : 0;
+        if (reverse && leaveCost == PATH_COST_BLOCKED) continue;
+
+        Hex hex = map->tiles[current].position;
+        growPathBounds(&scratch->explored, hex);
+        for (int dir = 0; dir < 6; dir++) {
+            Hex next = HexNeighbor(hex, dir);
+            int neighbor = GetTileIndex(map, next);
+            if (neighbor < 0 || !isInPathBounds(bounds, next)) continue;
+            int stepCost = GetPathStepCost(map, profile, neighbor);
+            if (stepCost == PATH_COST_BLOCKED) continue;
+
+            int g = scratch->g[current] + (reverse ? leaveCost : stepCost);
+            if (maxCost > 0 && g > maxCost) continue;
+            relaxPathTile(scratch, neighbor, g, pathHeuristic(&heuristic, next), current);
+        }
+
+        // Overlay edges: out of the tile, or into it when searching backwards
+        int e = reverse ? FirstOverlayEdgeTo(map, current) : FirstOverlayEdgeFrom(map, current);
+        while (e >= 0) {
+            const MapOverlayEdge* edge = &map->overlayEdges[e];
+            int other = reverse ? edge->from : edge->to;
+            e = reverse ? edge->nextIn : edge->nextOut;
+
+            Hex next = map->tiles[other].position;
+            growPathBounds(&scratch->explored, next);
+            if (!isInPathBounds(bounds, next) || GetPathStepCost(map, profile, other) == PATH_COST_BLOCKED) continue;
+
+            int g = scratch->g[current] + edge->cost;
+            if (maxCost > 0 && g > maxCost) continue;
+            relaxPathTile(scratch, other, g, pathHeuristic(&heuristic, next), current);
+        }
+    }
+    return (goalIndex < 0);
+}
+
+// Writes the route ending at goalIndex found by the last search; returns its length in tiles
+static int writeFoundPath(const PathScratch* scratch, int goalIndex, int* path, int maxPath) {
+    int length = 0;
+    for (int t = goalIndex; t >= 0; t = scratch->parent[t]) length++;
+    if (path != NULL && length <= maxPath) {
+        int i = length;
+        for (int t = goalIndex; t >= 0; t = scratch->parent[t]) path[--i] = t;
+    }
+    return length;
+}
+
+// Compact code of a found step between two tiles that cost stepCost: the HexNeighbor()
+// direction (0-5), or PATH_STEP_OVERLAY + k for the k-th overlay edge leaving from. A tile
+// can be both a neighbour and the end of an edge, so the edge is only picked if its cost
+// matches. Returns -1 if the tiles are not linked.
+static int encodePathStep(const Map* map, int from, int to, int stepCost) {
+    int k = 0;
+    for (int e = FirstOverlayEdgeFrom(map, from); e >= 0; e = map->overlayEdges[e].nextOut, k++) {
+        if (map->overlayEdges[e].to == to && map->overlayEdges[e].cost == stepCost) return PATH_STEP_OVERLAY + k;
+    }
+    Hex step = HexSubtract(map->tiles[to].position, map->tiles[from].position);
+    for (int dir = 0; dir < 6; dir++) {
+        Hex offset = HexDirection(dir);
+        if (offset.q == step.q && offset.r == step.r) return dir;
+    }
+    return -1;
+}
+
+// Tile reached by taking the step with the given code from a tile
+static int decodePathStep(const Map* map, int from, int code) {
+    if (code < PATH_STEP_OVERLAY) {
+        return GetTileIndex(map, HexNeighbor(map->tiles[from].position, code));
+    }
+    int e = FirstOverlayEdgeFrom(map, from);
+    for (int k = PATH_STEP_OVERLAY; k < code; k++) e = map->overlayEdges[e].nextOut;
+    return map->overlayEdges[e].to;
+}
+
+// Finds the cheapest path from start to goal that stays inside bounds (NULL: whole map).
+// On success writes the tile indices of the path (start first, goal last) to path if it has
+// room for them, stores the total cost in totalCost (if not NULL) and returns the number of
+// tiles on the path; returns the length even when maxPath is too small, so the caller can
+// retry with a larger buffer. Returns 0 if the goal cannot be reached (the start tile itself
+// does not need to be enterable).
+int FindPathInBounds(PathScratch* scratch, const Map* map, const PathProfile* profile, Hex start, Hex goal, const PathBounds* bounds, int* path, int maxPath, int* totalCost) {
+    int startIndex = GetTileIndex(map, start);
+    int goalIndex = GetTileIndex(map, goal);
+    if (startIndex < 0 || goalIndex < 0) {
+        return 0;
+    }
+    if (startIndex != goalIndex && GetPathStepCost(map, profile, goalIndex) == PATH_COST_BLOCKED) {
+        return 0;
+    }
+    if (!searchPath(scratch, map, profile, startIndex, goalIndex, bounds, false, 0)) {
+        return 0;
+    }
+
+    if (totalCost != NULL) *totalCost = scratch->g[goalIndex];
+    return writeFoundPath(scratch, goalIndex, path, maxPath);
+}
+
+int FindPath(PathScratch* scratch, const Map* map, const PathProfile* profile, Hex start, Hex goal, int* path, int maxPath, int* totalCost) {
+    return FindPathInBounds(scratch, map, profile, start, goal, NULL, path, maxPath, totalCost);
+}
+
+// Dijkstra from origin over the tiles inside bounds (NULL: whole map), up to maxCost (0: no
+// limit). With reverse set, the costs are those of reaching origin from each tile. Read the
+// results with GetExpandedPathCost() until the scratch is used again; the reached tiles are
+// also listed in scratch->expandedTiles, cheapest first. Returns the number of tiles
+// reached, origin included.
+int ExpandPathCosts(PathScratch* scratch, const Map* map, const PathProfile* profile, Hex origin, const PathBounds* bounds, bool reverse, int maxCost) {
+    int originIndex = GetTileIndex(map, origin);
+    if (originIndex < 0) {
+        return 0;
+    }
+    searchPath(scratch, map, profile, originIndex, -1, bounds, reverse, maxCost);
+    return scratch->expanded;
+}
+
+// Cost computed for a tile by the last ExpandPathCosts() call, -1 if it was not reached
+int GetExpandedPathCost(const PathScratch* scratch, int tileIndex) {
+    return (scratch->stamp[tileIndex] == scratch->searchId) ? scratch->g[tileIndex] : -1;
+}
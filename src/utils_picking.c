@@ -0,0 +1,353 @@
+/*
+    This is a utility file for mapping the mouse (or any screen point) to hex tiles.
+
+    Picking is done every frame for hover highlights and tooltips, so the result of the last
+    pick is cached together with a pixel-space rectangle that is guaranteed to lie inside the
+    picked hex. While the screen point stays inside that rectangle (or does not move at all)
+    and the camera, layout and map are unchanged, the cached tile is returned without running
+    PixelToHex() or GetTileAt().
+
+    Tile artwork rarely matches the hex geometry exactly (see the size.y divisor in main.c), so
+    PixelToHex() can disagree with what is drawn near tile edges. A PickMask resolves the topmost
+    drawn tile instead: the hex lattice is periodic, so for every sample of one lattice cell (in
+    fractional hex coordinates) the mask stores which neighbouring hexes' sprites may cover that
+    sample, topmost first. A pick is then a floor, one table lookup and a footprint test for at
+    most a few candidates, with PixelToHex() as the fallback where no sprite is drawn. The mask
+    also stores a rectangle around the hex center where only the hex's own sprite is drawn, so
+    the pick cache still skips lookups while the cursor stays inside it.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - ResetPickCache: Clears a pick cache so the next pick recomputes (keeps its mask).
+    - HexInnerBounds: Returns the largest axis-aligned rectangle inside a hex.
+    - PickTileCached: Returns the tile under a screen point, recomputing only when needed.
+    - BuildPickMask: Precomputes the sprite coverage lookup for a layout.
+    - UnloadPickMask: Frees the memory allocated for a pick mask.
+    - PickTileMasked: Returns the topmost drawn tile under a world point in O(1).
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - PickCache: Last picked hex/tile with the state it was computed for.
+    - PickMask: Per-layout sprite coverage lookup for pixel-accurate picking.
+*/
+
+#include <raylib.h>
+#include <stdlib.h>
+
+#define PICK_MASK_CANDIDATES 4  // Overlapping sprites remembered per sample (topmost first)
+#define PICK_MASK_NONE 127      // Marks unused candidate slots
+
+typedef struct PickMask {
+    Layout layout;              // Layout the mask was built for
+    int resolution;             // Samples per lattice step along q and r
+    signed char* offsets;       // (dq, dr) candidates per sample, PICK_MASK_CANDIDATES pairs each
+    unsigned char* footprint;   // Sprite pixels that count as the tile (1) or not (0)
+    int footprintWidth;         // Footprint size in sprite pixels
+    int footprintHeight;
+    Vector2 spriteSize;         // Size the sprite is drawn with in world space
+    Vector2 innerHalfSize;      // Half size of a rectangle around any hex center that always picks that hex
+} PickMask;
+
+typedef struct PickCache {
+    bool valid;             // Is the cached result usable?
+    Layout layout;          // Layout the result was computed with
+    Camera2D camera;        // Camera the result was computed with
+    const Map* map;         // Map the result was computed for
+    const Tile* mapTiles;   // Tile array of that map (detects re-creation)
+    Vector2 screenPoint;    // Screen point of the last pick
+    Hex hex;                // Hex under the screen point
+    Tile* tile;             // Tile under the screen point (NULL if outside the map)
+    Rectangle bounds;       // World-space rectangle inside the hex
+    const PickMask* mask;   // Pixel-accurate picking when set (NULL: analytic PixelToHex())
+    const PickMask* usedMask; // Mask the cached result was computed with
+} PickCache;
+
+static bool layoutEquals(Layout a, Layout b) {
+    return a.orientation.f0 == b.orientation.f0 && a.orientation.f1 == b.orientation.f1 &&
+           a.orientation.f2 == b.orientation.f2 && a.orientation.f3 == b.orientation.f3 &&
+           a.orientation.start_angle == b.orientation.start_angle &&
+           a.size.x == b.size.x && a.size.y == b.size.y &&
+           a.origin.x == b.origin.x && a.origin.y == b.origin.y;
+}
+
+static bool cameraEquals(Camera2D a, Camera2D b) {
+    return a.offset.x == b.offset.x && a.offset.y == b.offset.y &&
+           a.target.x == b.target.x && a.target.y == b.target.y &&
+           a.rotation == b.rotation && a.zoom == b.zoom;
+}
+
+void ResetPickCache(PickCache* cache) {
+    cache->valid = false;
+    cache->map = NULL;
+    cache->mapTiles = NULL;
+    cache->tile = NULL;
+    cache->usedMask = NULL;
+}
+
+Rectangle HexInnerBounds(Layout layout, Hex hex) {
+    // One of the first two corners always has both offsets non-zero (30° for pointy-top,
+    // 60° for flat-top); the rectangle spanned by it is inscribed in the hex.
+    Point center = HexToPixel(layout, hex);
+    Point c0 = HexCornerOffset(layout, 0);
+    Point c1 = HexCornerOffset(layout, 1);
+    float fit0 = fminf(fabsf(c0.x) / fabsf(layout.size.x), fabsf(c0.y) / fabsf(layout.size.y));
+    float fit1 = fminf(fabsf(c1.x) / fabsf(layout.size.x), fabsf(c1.y) / fabsf(layout.size.y));
+    Point corner = (fit0 >= fit1) ? c0 : c1;
+
+    // Inset slightly so points on the shared hex edges are never claimed by the wrong hex
+    float halfWidth = fabsf(corner.x) * 0.99f;
+    float halfHeight = fabsf(corner.y) * 0.99f;
+
+    return (Rectangle){ center.x - halfWidth, center.y - halfHeight, 2.0f * halfWidth, 2.0f * halfHeight };
+}
+
+// Fractional (q, r) of a world point, i.e. PixelToHex() without rounding
+static Vector2 pixelToFractional(Layout layout, Vector2 point) {
+    Orientation M = layout.orientation;
+    float x = (point.x - layout.origin.x) / layout.size.x;
+    float y = (point.y - layout.origin.y) / layout.size.y;
+    return (Vector2){ M.b0 * x + M.b1 * y, M.b2 * x + M.b3 * y };
+}
+
+// World offset of a fractional (q, r) from the layout origin
+static Vector2 fractionalToPixel(Layout layout, float q, float r) {
+    Orientation M = layout.orientation;
+    return (Vector2){ (M.f0 * q + M.f1 * r) * layout.size.x, (M.f2 * q + M.f3 * r) * layout.size.y };
+}
+
+// Footprint pixel of a world offset from the sprite's hex center (-1 when outside the sprite)
+static int footprintPixel(const PickMask* mask, Vector2 local) {
+    int px = (int)floorf((local.x / mask->spriteSize.x + 0.5f) * mask->footprintWidth);
+    int py = (int)floorf((local.y / mask->spriteSize.y + 0.5f) * mask->footprintHeight);
+    if (px < 0 || py < 0 || px >= mask->footprintWidth || py >= mask->footprintHeight) {
+        return -1;
+    }
+    return py * mask->footprintWidth + px;
+}
+
+// Does the footprint, grown by one pixel, touch this offset? (conservative for a whole sample)
+static bool footprintNear(const PickMask* mask, Vector2 local) {
+    Vector2 pixel = { mask->spriteSize.x / mask->footprintWidth, mask->spriteSize.y / mask->footprintHeight };
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int index = footprintPixel(mask, (Vector2){ local.x + dx * pixel.x, local.y + dy * pixel.y });
+            if (index >= 0 && mask->footprint[index]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Is the footprint, shrunk by one pixel, covering this offset? (conservative for a whole sample)
+static bool footprintSolid(const PickMask* mask, Vector2 local) {
+    Vector2 pixel = { mask->spriteSize.x / mask->footprintWidth, mask->spriteSize.y / mask->footprintHeight };
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int index = footprintPixel(mask, (Vector2){ local.x + dx * pixel.x, local.y + dy * pixel.y });
+            if (index < 0 || !mask->footprint[index]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Does every sample a rectangle around the center of hex (0, 0) touches pick that hex? solid
+// marks the samples whose only candidate covers the whole sample. Points are tested on a grid
+// finer than the thinnest sample, over the rectangle grown by a sample, so no sample is missed.
+static bool pickRectIsInner(const PickMask* mask, const bool* solid, Vector2 halfSize, float step, float margin) {
+    for (float y = -halfSize.y - margin; y <= halfSize.y + margin; y += step) {
+        for (float x = -halfSize.x - margin; x <= halfSize.x + margin; x += step) {
+            Vector2 world = { mask->layout.origin.x + x, mask->layout.origin.y + y };
+            Vector2 f = pixelToFractional(mask->layout, world);
+            float baseQ = floorf(f.x);
+            float baseR = floorf(f.y);
+            int iu = (int)((f.x - baseQ) * mask->resolution);
+            int iv = (int)((f.y - baseR) * mask->resolution);
+            if (iu >= mask->resolution) iu = mask->resolution - 1;
+            if (iv >= mask->resolution) iv = mask->resolution - 1;
+
+            int sample = iv * mask->resolution + iu;
+            const signed char* slot = &mask->offsets[sample * PICK_MASK_CANDIDATES * 2];
+            if (!solid[sample] || slot[0] != -(int)baseQ || slot[1] != -(int)baseR) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void UnloadPickMask(PickMask* mask) {
+    free(mask->offsets);
+    free(mask->footprint);
+    mask->offsets = NULL;
+    mask->footprint = NULL;
+}
+
+// The sprite is drawn centered on the hex center with the given world size. Tiles are drawn in
+// storage order (r, then q ascending), so a larger (dr, dq) is drawn on top.
+PickMask BuildPickMask(Layout layout, Image sprite, Vector2 spriteSize, unsigned char alphaThreshold) {
+    PickMask mask = { 0 };
+    mask.layout = layout;
+    mask.spriteSize = spriteSize;
+    mask.footprintWidth = sprite.width;
+    mask.footprintHeight = sprite.height;
+
+    // About one sample per world pixel; candidates are verified against the footprint per pick
+    Vector2 stepQ = fractionalToPixel(layout, 1.0f, 0.0f);
+    Vector2 stepR = fractionalToPixel(layout, 0.0f, 1.0f);
+    mask.resolution = (int)ceilf(fmaxf(Vector2Length(stepQ), Vector2Length(stepR)));
+    if (mask.resolution < 1) mask.resolution = 1;
+
+    int sampleCount = mask.resolution * mask.resolution;
+    mask.offsets = (signed char*)malloc(sampleCount * PICK_MASK_CANDIDATES * 2);
+    mask.footprint = (unsigned char*)malloc((sprite.width > 0 && sprite.height > 0) ? sprite.width * sprite.height : 1);
+    if (mask.offsets == NULL || mask.footprint == NULL || sprite.data == NULL) {
+        TraceLog(LOG_ERROR, "Failed to build pick mask");
+        UnloadPickMask(&mask);
+        return mask;
+    }
+
+    Color* pixels = LoadImageColors(sprite);
+    for (int i = 0; i < sprite.width * sprite.height; i++) {
+        mask.footprint[i] = (pixels[i].a >= alphaThreshold) ? 1 : 0;
+    }
+    UnloadImageColors(pixels);
+    bool* solid = (bool*)calloc(sampleCount, sizeof(bool));    // Only sizes the cache rectangle
+
+    // Only hexes whose sprite can reach the sample cell need to be tested
+    int reach = 1 + (int)ceilf(fmaxf(spriteSize.x, spriteSize.y) / fminf(Vector2Length(stepQ), Vector2Length(stepR)));
+    if (reach > 8) reach = 8;
+
+    for (int iv = 0; iv < mask.resolution; iv++) {
+        for (int iu = 0; iu < mask.resolution; iu++) {
+            float u = (iu + 0.5f) / mask.resolution;
+            float v = (iv + 0.5f) / mask.resolution;
+            Vector2 sample = fractionalToPixel(layout, u, v);
+            signed char* slot = &mask.offsets[(iv * mask.resolution + iu) * PICK_MASK_CANDIDATES * 2];
+            int found = 0;
+
+            // Visit candidates topmost first so the first hits are the ones kept
+            for (int dr = reach; dr >= -reach && found < PICK_MASK_CANDIDATES; dr--) {
+                for (int dq = reach; dq >= -reach && found < PICK_MASK_CANDIDATES; dq--) {
+                    Vector2 local = Vector2Subtract(sample, fractionalToPixel(layout, (float)dq, (float)dr));
+                    if (!footprintNear(&mask, local)) continue;
+
+                    slot[found * 2] = (signed char)dq;
+                    slot[found * 2 + 1] = (signed char)dr;
+                    found++;
+                }
+            }
+            for (int k = found; k < PICK_MASK_CANDIDATES; k++) {
+                slot[k * 2] = PICK_MASK_NONE;
+                slot[k * 2 + 1] = PICK_MASK_NONE;
+            }
+            if (solid != NULL && found == 1) {
+                Vector2 local = Vector2Subtract(sample, fractionalToPixel(layout, (float)slot[0], (float)slot[1]));
+                solid[iv * mask.resolution + iu] = footprintSolid(&mask, local);
+            }
+        }
+    }
+
+    // Largest scaled copy of HexInnerBounds() whose samples all pick the hex, so the pick
+    // cache can skip lookups while the cursor stays inside it (as with analytic picking)
+    if (solid != NULL) {
+        Vector2 cellQ = Vector2Scale(stepQ, 1.0f / mask.resolution);
+        Vector2 cellR = Vector2Scale(stepR, 1.0f / mask.resolution);
+        float area = fabsf(cellQ.x * cellR.y - cellQ.y * cellR.x);
+        float thinnest = area / fmaxf(Vector2Length(cellQ), Vector2Length(cellR));
+        float margin = Vector2Length(cellQ) + Vector2Length(cellR);
+        Rectangle hexBounds = HexInnerBounds(layout, (Hex){ 0, 0, 0 });
+        for (int tenths = 10; tenths > 0; tenths--) {
+            Vector2 halfSize = { hexBounds.width * 0.05f * tenths, hexBounds.height * 0.05f * tenths };
+            if (pickRectIsInner(&mask, solid, halfSize, 0.5f * thinnest, margin)) {
+                mask.innerHalfSize = halfSize;
+                break;
+            }
+        }
+        free(solid);
+    }
+
+    return mask;
+}
+
+// Falls back to PixelToHex() when no drawn sprite of a map tile covers the point, or when
+// the mask was built for a different layout
+Tile* PickTileMasked(const PickMask* mask, Map* map, Layout layout, Vector2 worldPoint, Hex* hex) {
+    if (mask != NULL && mask->offsets != NULL && layoutEquals(mask->layout, layout)) {
+        Vector2 f = pixelToFractional(layout, worldPoint);
+        float baseQ = floorf(f.x);
+        float baseR = floorf(f.y);
+        int iu = (int)((f.x - baseQ) * mask->resolution);
+        int iv = (int)((f.y - baseR) * mask->resolution);
+        if (iu >= mask->resolution) iu = mask->resolution - 1;
+        if (iv >= mask->resolution) iv = mask->resolution - 1;
+
+        const signed char* slot = &mask->offsets[(iv * mask->resolution + iu) * PICK_MASK_CANDIDATES * 2];
+        for (int k = 0; k < PICK_MASK_CANDIDATES && slot[k * 2] != PICK_MASK_NONE; k++) {
+            int q = (int)baseQ + slot[k * 2];
+            int r = (int)baseR + slot[k * 2 + 1];
+            Hex candidate = { q, r, -q - r };
+            Point center = HexToPixel(layout, candidate);
+            int pixel = footprintPixel(mask, (Vector2){ worldPoint.x - center.x, worldPoint.y - center.y });
+            if (pixel < 0 || !mask->footprint[pixel]) continue;
+
+            int index = GetTileIndex(map, candidate);
+            if (index >= 0) {
+                *hex = candidate;
+                return &map->tiles[index];
+            }
+        }
+    }
+
+    *hex = PixelToHex(layout, (Point){ worldPoint.x, worldPoint.y });
+    return GetTileAt(map, *hex);
+}
+
+Tile* PickTileCached(PickCache* cache, Map* map, Layout layout, Camera2D camera, Vector2 screenPoint) {
+    bool sameState = cache->valid && cache->map == map && cache->mapTiles == map->tiles &&
+                     cache->usedMask == cache->mask &&
+                     layoutEquals(cache->layout, layout) && cameraEquals(cache->camera, camera);
+
+    // Mouse at rest: nothing to do
+    if (sameState && cache->screenPoint.x == screenPoint.x && cache->screenPoint.y == screenPoint.y) {
+        return cache->tile;
+    }
+
+    Vector2 world = GetScreenToWorld2D(screenPoint, camera);
+    cache->screenPoint = screenPoint;
+
+    // Still inside the hex we picked last time
+    if (sameState && CheckCollisionPointRec(world, cache->bounds)) {
+        return cache->tile;
+    }
+
+    if (cache->mask != NULL) {
+        // Sprite footprints are not hex shaped; only the rectangle around the hex center that
+        // the mask guarantees to pick the hex can skip the lookup
+        cache->tile = PickTileMasked(cache->mask, map, layout, world, &cache->hex);
+        Point center = HexToPixel(layout, cache->hex);
+        Vector2 half = cache->mask->innerHalfSize;
+        cache->bounds = (Rectangle){ center.x - half.x, center.y - half.y, 2.0f * half.x, 2.0f * half.y };
+        if (!layoutEquals(cache->mask->layout, layout) || !CheckCollisionPointRec(world, cache->bounds)) {
+            cache->bounds = (Rectangle){ 0 };
+        }
+    }
+    else {
+        Hex hex = PixelToHex(layout, (Point){ world.x, world.y });
+        if (!sameState || !HexEquals(hex, cache->hex)) {
+            cache->hex = hex;
+            cache->tile = GetTileAt(map, hex);
+            cache->bounds = HexInnerBounds(layout, hex);
+        }
+    }
+
+    cache->valid = true;
+    cache->layout = layout;
+    cache->camera = camera;
+    cache->map = map;
+    cache->mapTiles = map->tiles;
+    cache->usedMask = cache->mask;
+    return cache->tile;
+}
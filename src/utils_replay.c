@@ -0,0 +1,189 @@
+/*
+    This is a utility file for recording the input event stream and replaying it later.
+
+    Every event consumed by the game is stored together with the number of the frame that
+    consumed it and its original time stamp, and the recording keeps the random seed the session started with. Replaying
+    pushes the events of each frame back into an InputQueue before that frame's update, so the
+    simulation sees exactly the same input in the same frames. Positions are the game's virtual
+    mouse coordinates, so a replay does not depend on the window size and can run headless.
+
+    File format (native byte order):
+    ------------------------------------------------------------------------
+    - Header: magic "DGIR", version, record count, frame count, random seed (5 x 4 bytes)
+    - Records (24 bytes each): frame (u32), code (u16), type (u8), modifiers (u8), x (f32), y (f32),
+      time (f64)
+      For INPUT_MOUSE_WHEEL records the code field holds the wheel movement in 1/256 steps.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - RecordInputEvent: Appends a consumed event to a recording.
+    - SaveInputRecording: Writes a recording to a file.
+    - LoadInputRecording: Reads a recording from a file.
+    - UnloadInputRecording: Frees the memory allocated for a recording.
+    - ReplayInputFrame: Pushes the recorded events of one frame into an input queue.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - InputRecord: Recorded event with its frame number.
+    - InputRecording: Growable array of records plus replay cursor.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INPUT_RECORDING_MAGIC "DGIR"
+#define INPUT_RECORDING_VERSION 1
+#define INPUT_RECORDING_HEADER_SIZE 20
+#define INPUT_RECORD_SIZE 24
+
+typedef struct InputRecord {
+    unsigned int frame;     // Frame that consumed the event
+    InputEvent event;       // Recorded event
+} InputRecord;
+
+typedef struct InputRecording {
+    InputRecord* records;   // Dynamic array of records, ordered by frame
+    int count;              // Number of records
+    int capacity;           // Allocated records
+    unsigned int frameCount;// Number of frames covered by the recording (including idle ones)
+    unsigned int seed;      // Random seed the recorded session started with
+    int cursor;             // Next record to replay
+} InputRecording;
+
+void RecordInputEvent(InputRecording* recording, unsigned int frame, const InputEvent* event) {
+    if (recording->count == recording->capacity) {
+        int capacity = (recording->capacity > 0) ? recording->capacity * 2 : 256;
+        InputRecord* records = (InputRecord*)realloc(recording->records, capacity * sizeof(InputRecord));
+        if (records == NULL) {
+            TraceLog(LOG_ERROR, "Failed to grow input recording to %d records", capacity);
+            return;
+        }
+        recording->records = records;
+        recording->capacity = capacity;
+    }
+
+    recording->records[recording->count].frame = frame;
+    recording->records[recording->count].event = *event;
+    recording->count++;
+    if (frame + 1 > recording->frameCount) {
+        recording->frameCount = frame + 1;
+    }
+}
+
+// frameCount is the number of frames the session ran, so idle frames after the last event replay too
+bool SaveInputRecording(const InputRecording* recording, unsigned int frameCount, const char* fileName) {
+    int dataSize = INPUT_RECORDING_HEADER_SIZE + recording->count * INPUT_RECORD_SIZE;
+    unsigned char* data = (unsigned char*)malloc(dataSize);
+    if (data == NULL) {
+        return false;
+    }
+
+    if (frameCount < recording->frameCount) {
+        frameCount = recording->frameCount;
+    }
+    uint32_t header[4] = { INPUT_RECORDING_VERSION, (uint32_t)recording->count, frameCount, recording->seed };
+    memcpy(data, INPUT_RECORDING_MAGIC, 4);
+    memcpy(data + 4, header, sizeof(header));
+
+    unsigned char* out = data + INPUT_RECORDING_HEADER_SIZE;
+    for (int i = 0; i < recording->count; i++) {
+        const InputEvent* event = &recording->records[i].event;
+        uint32_t frame = recording->records[i].frame;
+        uint16_t code = (event->type == INPUT_MOUSE_WHEEL) ? (uint16_t)(int16_t)(event->wheel * 256.0f) : (uint16_t)event->code;
+        uint8_t type = (uint8_t)event->type;
+        uint8_t modifiers = (uint8_t)event->modifiers;
+
+        memcpy(out, &frame, 4);
+        memcpy(out + 4, &code, 2);
+        out[6] = type;
+        out[7] = modifiers;
+        memcpy(out + 8, &event->position.x, 4);
+        memcpy(out + 12, &event->position.y, 4);
+        memcpy(out + 16, &event->time, 8);
+        out += INPUT_RECORD_SIZE;
+    }
+
+    bool success = SaveFileData(fileName, data, dataSize);
+    free(data);
+    return success;
+}
+
+InputRecording LoadInputRecording(const char* fileName) {
+    InputRecording recording = { 0 };
+
+    int dataSize = 0;
+    unsigned char* data = LoadFileData(fileName, &dataSize);
+    if (data == NULL) {
+        return recording;
+    }
+
+    uint32_t header[4] = { 0 };
+    if (dataSize >= INPUT_RECORDING_HEADER_SIZE) {
+        memcpy(header, data + 4, sizeof(header));
+    }
+    if (dataSize < INPUT_RECORDING_HEADER_SIZE || memcmp(data, INPUT_RECORDING_MAGIC, 4) != 0 ||
+        header[0] != INPUT_RECORDING_VERSION ||
+        (int)header[1] > (dataSize - INPUT_RECORDING_HEADER_SIZE) / INPUT_RECORD_SIZE) {
+        TraceLog(LOG_ERROR, "Invalid input recording: %s", fileName);
+        UnloadFileData(data);
+        return recording;
+    }
+
+    int count = (int)header[1];
+    recording.records = (InputRecord*)malloc((count > 0 ? count : 1) * sizeof(InputRecord));
+    recording.capacity = (recording.records != NULL) ? count : 0;
+    recording.frameCount = header[2];
+    recording.seed = header[3];
+
+    const unsigned char* in = data + INPUT_RECORDING_HEADER_SIZE;
+    for (int i = 0; i < recording.capacity; i++) {
+        InputRecord record = { 0 };
+        uint32_t frame;
+        uint16_t code;
+        memcpy(&frame, in, 4);
+        memcpy(&code, in + 4, 2);
+        record.frame = frame;
+        record.event.type = (InputEventType)in[6];
+        record.event.modifiers = in[7];
+        memcpy(&record.event.position.x, in + 8, 4);
+        memcpy(&record.event.position.y, in + 12, 4);
+        memcpy(&record.event.time, in + 16, 8);
+        if (record.event.type == INPUT_MOUSE_WHEEL) {
+            record.event.wheel = (float)(int16_t)code / 256.0f;
+        }
+        else {
+            record.event.code = code;
+        }
+        recording.records[recording.count++] = record;
+        in += INPUT_RECORD_SIZE;
+    }
+
+    UnloadFileData(data);
+    return recording;
+}
+
+void UnloadInputRecording(InputRecording* recording) {
+    if (recording->records != NULL) {
+        free(recording->records);
+        recording->records = NULL;
+    }
+    recording->count = 0;
+    recording->capacity = 0;
+    recording->frameCount = 0;
+    recording->seed = 0;
+    recording->cursor = 0;
+}
+
+// Events keep their recorded time, so time-based input handling (stroke merging) replays exactly
+int ReplayInputFrame(InputRecording* recording, unsigned int frame, InputQueue* queue) {
+    int pushed = 0;
+    while (recording->cursor < recording->count && recording->records[recording->cursor].frame <= frame) {
+        if (PushInputEvent(queue, recording->records[recording->cursor].event)) {
+            pushed++;
+        }
+        recording->cursor++;
+    }
+    return pushed;
+}
@@ -0,0 +1,224 @@
+/*
+    This is a utility file for multi-tile selection (box and lasso) on a hex map.
+
+    Selections are stored as a bitset over tile indices and mirrored into Tile.isSelected so
+    the renderer keeps working unchanged. Polygon selection rasterizes the polygon one map row
+    at a time: the row's hex centers lie on a line, the polygon edges are intersected with that
+    line and every span between an entering and a leaving crossing (even-odd rule) selects a
+    contiguous run of the tile array. No per-tile point-in-polygon tests are performed.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - CreateTileSelection: Allocates an empty selection for a map.
+    - DestroyTileSelection: Frees the memory allocated for the selection.
+    - IsTileIndexSelected: Checks the selection bit of a tile index.
+    - NextSelectedTile: Iterates selected tile indices in ascending order.
+    - ClearTileSelection: Deselects every selected tile.
+    - SelectTileRange: Selects a contiguous range of tile indices.
+    - SelectSingleTile: Replaces the selection with a single tile.
+    - SelectTilesInPolygon: Selects all tiles whose centers lie inside a world-space polygon.
+    - SelectTilesInRect: Selects all tiles whose centers lie inside a world-space rectangle.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - TileSelection: Bitset of selected tile indices with a running count.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define MAX_ROW_CROSSINGS 256 // Polygon edge crossings per map row kept on the stack (more are allocated)
+
+typedef struct TileSelection {
+    uint32_t* bits;     // One bit per tile index
+    int wordCount;      // Number of 32-bit words in bits
+    int count;          // Number of selected tiles
+} TileSelection;
+
+TileSelection CreateTileSelection(const Map* map) {
+    TileSelection selection;
+    selection.wordCount = (map->tileCount + 31) / 32;
+    selection.bits = (uint32_t*)calloc(selection.wordCount, sizeof(uint32_t));
+    selection.count = 0;
+    return selection;
+}
+
+void DestroyTileSelection(TileSelection* selection) {
+    if (selection->bits != NULL) {
+        free(selection->bits);
+        selection->bits = NULL;
+        selection->wordCount = 0;
+        selection->count = 0;
+    }
+}
+
+bool IsTileIndexSelected(const TileSelection* selection, int index) {
+    return (selection->bits[index >> 5] >> (index & 31)) & 1u;
+}
+
+// Returns the first selected index greater than 'after' (pass -1 to start), or -1 when done
+int NextSelectedTile(const TileSelection* selection, int after) {
+    int index = after + 1;
+    int word = index >> 5;
+    if (word >= selection->wordCount) {
+        return -1;
+    }
+
+    uint32_t bits = selection->bits[word] & (~0u << (index & 31));
+    while (bits == 0) {
+        word++;
+        if (word >= selection->wordCount) {
+            return -1;
+        }
+        bits = selection->bits[word];
+    }
+    return word * 32 + __builtin_ctz(bits);
+}
+
+void ClearTileSelection(TileSelection* selection, Map* map) {
+    for (int i = NextSelectedTile(selection, -1); i >= 0; i = NextSelectedTile(selection, i)) {
+        map->tiles[i].isSelected = false;
+    }
+    for (int w = 0; w < selection->wordCount; w++) {
+        selection->bits[w] = 0;
+    }
+    selection->count = 0;
+}
+
+void SelectTileRange(TileSelection* selection, Map* map, int first, int last) {
+    if (first < 0) first = 0;
+    if (last >= map->tileCount) last = map->tileCount - 1;
+    if (first > last) return;
+
+    // Whole words at a time; the popcount keeps the running count exact
+    int firstWord = first >> 5;
+    int lastWord = last >> 5;
+    for (int w = firstWord; w <= lastWord; w++) {
+        uint32_t mask = ~0u;
+        if (w == firstWord) mask &= ~0u << (first & 31);
+        if (w == lastWord) mask &= ~0u >> (31 - (last & 31));
+        selection->count += __builtin_popcount(mask & ~selection->bits[w]);
+        selection->bits[w] |= mask;
+    }
+
+    for (int i = first; i <= last; i++) {
+        map->tiles[i].isSelected = true;
+    }
+}
+
+void SelectSingleTile(TileSelection* selection, Map* map, Hex position) {
+    ClearTileSelection(selection, map);
+    int index = GetTileIndex(map, position);
+    if (index >= 0) {
+        SelectTileRange(selection, map, index, index);
+    }
+}
+
+// Returns the number of tiles selected by this call (already selected tiles are not counted)
+int SelectTilesInPolygon(TileSelection* selection, Map* map, Layout layout, const Vector2* points, int pointCount, bool additive) {
+    // A row line crosses every polygon edge at most once, so pointCount crossings always fit
+    float stackCrossings[MAX_ROW_CROSSINGS];
+    float* crossings = stackCrossings;
+    if (pointCount > MAX_ROW_CROSSINGS) {
+        crossings = (float*)malloc(pointCount * sizeof(float));
+        if (crossings == NULL) {
+            TraceLog(LOG_WARNING, "Selection polygon with %d points rejected: out of memory", pointCount);
+            return 0;
+        }
+    }
+
+    if (!additive) {
+        ClearTileSelection(selection, map);
+    }
+    if (pointCount < 3) {
+        if (crossings != stackCrossings) free(crossings);
+        return 0;
+    }
+
+    int before = selection->count;
+
+    // Step from one hex center to the next along a row (q + 1)
+    Orientation M = layout.orientation;
+    Vector2 step = { M.f0 * layout.size.x, M.f2 * layout.size.y };
+    Vector2 normal = { -step.y, step.x };
+    float stepLengthSqr = step.x * step.x + step.y * step.y;
+
+    // Only rows whose center line can touch the polygon need to be visited
+    float minDist = INFINITY;
+    float maxDist = -INFINITY;
+    Point origin = HexToPixel(layout, MakeHex(0, 0, 0));
+    for (int i = 0; i < pointCount; i++) {
+        float d = (points[i].x - origin.x) * normal.x + (points[i].y - origin.y) * normal.y;
+        if (d < minDist) minDist = d;
+        if (d > maxDist) maxDist = d;
+    }
+    Point rowOffset = HexToPixel(layout, MakeHex(0, 1, -1));
+    float rowDist = (rowOffset.x - origin.x) * normal.x + (rowOffset.y - origin.y) * normal.y;
+    int rFrom = -map->radius;
+    int rTo = map->radius;
+    if (rowDist != 0.0f) {
+        float r0 = minDist / rowDist;
+        float r1 = maxDist / rowDist;
+        if (r0 > r1) { float t = r0; r0 = r1; r1 = t; }
+        if ((int)floorf(r0) > rFrom) rFrom = (int)floorf(r0);
+        if ((int)ceilf(r1) < rTo) rTo = (int)ceilf(r1);
+    }
+
+    for (int r = rFrom; r <= rTo; r++) {
+        int firstIndex, qMin, qMax;
+        if (!GetMapRow(map, r, &firstIndex, &qMin, &qMax)) {
+            continue;
+        }
+
+        // Row line: rowStart + q * step
+        Point rowStart = HexToPixel(layout, (Hex){ 0, r, -r });
+        int crossingCount = 0;
+        for (int i = 0; i < pointCount; i++) {
+            Vector2 a = points[i];
+            Vector2 b = points[(i + 1) % pointCount];
+            float da = (a.x - rowStart.x) * normal.x + (a.y - rowStart.y) * normal.y;
+            float db = (b.x - rowStart.x) * normal.x + (b.y - rowStart.y) * normal.y;
+            if ((da > 0.0f) == (db > 0.0f)) {
+                continue;
+            }
+            float t = da / (da - db);
+            float x = a.x + (b.x - a.x) * t - rowStart.x;
+            float y = a.y + (b.y - a.y) * t - rowStart.y;
+            float q = (x * step.x + y * step.y) / stepLengthSqr;
+
+            // Insertion sort keeps the (usually few) crossings ordered along the row
+            int j = crossingCount++;
+            while (j > 0 && crossings[j - 1] > q) {
+                crossings[j] = crossings[j - 1];
+                j--;
+            }
+            crossings[j] = q;
+        }
+
+        // Even-odd rule: each [enter, leave] pair covers a run of hex centers
+        for (int c = 0; c + 1 < crossingCount; c += 2) {
+            int qFrom = (int)ceilf(crossings[c]);
+            int qTo = (int)floorf(crossings[c + 1]);
+            if (qFrom < qMin) qFrom = qMin;
+            if (qTo > qMax) qTo = qMax;
+            if (qFrom <= qTo) {
+                SelectTileRange(selection, map, firstIndex + (qFrom - qMin), firstIndex + (qTo - qMin));
+            }
+        }
+    }
+
+    if (crossings != stackCrossings) free(crossings);
+    return selection->count - before;
+}
+
+int SelectTilesInRect(TileSelection* selection, Map* map, Layout layout, Rectangle rect, bool additive) {
+    Vector2 corners[4] = {
+        { rect.x, rect.y },
+        { rect.x + rect.width, rect.y },
+        { rect.x + rect.width, rect.y + rect.height },
+        { rect.x, rect.y + rect.height }
+    };
+    return SelectTilesInPolygon(selection, map, layout, corners, 4, additive);
+}
@@ -0,0 +1,237 @@
+/*
+    This is a utility file for undoing and redoing terrain edits on a hex map.
+
+    Instead of map snapshots, the history stores one delta per changed tile (tile index, old
+    terrain, new terrain) in a ring buffer made of fixed-size chunks. Chunks are allocated the
+    first time the ring reaches them and reused afterwards, so memory only grows with use and
+    never exceeds the configured delta budget; once the budget is full the oldest batches are
+    dropped. A batch groups the deltas of one user action (a whole brush stroke or a 10k tile
+    fill) and is reverted or reapplied with a single SetTileTypeList() call, which means one
+    walkability update and one change notification per undo step.
+
+    Consecutive mergeable batches (e.g. quick brush strokes) can be appended to the previous
+    batch so they undo together.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - CreateUndoHistory: Creates an empty history for a map with a delta budget.
+    - DestroyUndoHistory: Frees the memory allocated for the history.
+    - RecordTileTypes: Records the deltas of a bulk terrain change before it is applied.
+    - UndoMapChange: Reverts the most recent batch.
+    - RedoMapChange: Reapplies the most recently undone batch.
+    - CanUndoMapChange / CanRedoMapChange: Checks whether there is something to undo/redo.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - TileDelta: One tile terrain change (8 bytes).
+    - UndoBatch: Range of deltas forming one undo step.
+    - UndoHistory: Chunked delta ring, batch ring and revert scratch buffers.
+*/
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNDO_CHUNK_DELTAS 4096      // Deltas per chunk (32 KB)
+#define UNDO_MAX_BATCHES 256        // Undo steps kept at most
+
+typedef struct TileDelta {
+    int tileIndex;
+    unsigned char oldType;
+    unsigned char newType;
+} TileDelta;
+
+typedef struct UndoBatch {
+    unsigned int start;     // Ring position of the first delta
+    unsigned int count;     // Number of deltas
+    bool mergeable;         // Can the next mergeable batch be appended to this one?
+} UndoBatch;
+
+// Ring positions are free-running counters; the chunk count is a power of two so that
+// positions map to chunks correctly when the counters wrap around.
+typedef struct UndoHistory {
+    TileDelta** chunks;     // Lazily allocated delta chunks
+    int chunkCount;
+    unsigned int deltaTail; // Position of the oldest kept delta
+    unsigned int deltaHead; // Position after the newest delta
+
+    UndoBatch batches[UNDO_MAX_BATCHES];
+    int batchFirst;         // Ring slot of the oldest batch
+    int batchCount;         // Batches kept (applied + undone)
+    int batchApplied;       // Batches currently applied; the rest can be redone
+
+    uint32_t* seen;         // Per tile bit: tile already collected while reverting a batch
+    int* revertIndices;     // Tiles and types handed to SetTileTypeList
+    TileType* revertTypes;
+    int tileCount;
+} UndoHistory;
+
+// maxDeltas is the memory budget in tile changes (8 bytes each), rounded up to whole chunks
+UndoHistory CreateUndoHistory(const Map* map, int maxDeltas) {
+    UndoHistory history = { 0 };
+    int chunkCount = 1;
+    while (chunkCount * UNDO_CHUNK_DELTAS < maxDeltas) chunkCount *= 2;
+
+    history.chunks = (TileDelta**)calloc(chunkCount, sizeof(TileDelta*));
+    history.chunkCount = chunkCount;
+    history.tileCount = map->tileCount;
+    history.seen = (uint32_t*)calloc((map->tileCount + 31) / 32, sizeof(uint32_t));
+    history.revertIndices = (int*)malloc(map->tileCount * sizeof(int));
+    history.revertTypes = (TileType*)malloc(map->tileCount * sizeof(TileType));
+    return history;
+}
+
+void DestroyUndoHistory(UndoHistory* history) {
+    if (history->chunks != NULL) {
+        for (int i = 0; i < history->chunkCount; i++) {
+            free(history->chunks[i]);
+        }
+        free(history->chunks);
+    }
+    free(history->seen);
+    free(history->revertIndices);
+    free(history->revertTypes);
+    *history = (UndoHistory){ 0 };
+}
+
+bool CanUndoMapChange(const UndoHistory* history) {
+    return history->batchApplied > 0;
+}
+
+bool CanRedoMapChange(const UndoHistory* history) {
+    return history->batchApplied < history->batchCount;
+}
+
+static UndoBatch* undoBatchAt(UndoHistory* history, int i) {
+    return &history->batches[(history->batchFirst + i) % UNDO_MAX_BATCHES];
+}
+
+static TileDelta* undoDeltaAt(UndoHistory* history, unsigned int position) {
+    return &history->chunks[(position / UNDO_CHUNK_DELTAS) % history->chunkCount][position % UNDO_CHUNK_DELTAS];
+}
+
+static void dropOldestBatch(UndoHistory* history) {
+    history->batchFirst = (history->batchFirst + 1) % UNDO_MAX_BATCHES;
+    history->batchCount--;
+    history->batchApplied--;
+    history->deltaTail = (history->batchCount > 0) ? undoBatchAt(history, 0)->start : history->deltaHead;
+}
+
+// Appends a delta to the newest batch, dropping old batches when the budget is full.
+// Fails if the newest batch alone would exceed the budget.
+static bool pushDelta(UndoHistory* history, TileDelta delta) {
+    unsigned int capacity = (unsigned int)history->chunkCount * UNDO_CHUNK_DELTAS;
+    while (history->deltaHead - history->deltaTail == capacity) {
+        if (history->batchCount == 1) {
+            return false;
+        }
+        dropOldestBatch(history);
+    }
+
+    int chunk = (history->deltaHead / UNDO_CHUNK_DELTAS) % history->chunkCount;
+    if (history->chunks[chunk] == NULL) {
+        history->chunks[chunk] = (TileDelta*)malloc(UNDO_CHUNK_DELTAS * sizeof(TileDelta));
+        if (history->chunks[chunk] == NULL) {
+            return false;
+        }
+    }
+
+    *undoDeltaAt(history, history->deltaHead) = delta;
+    history->deltaHead++;
+    undoBatchAt(history, history->batchCount - 1)->count++;
+    return true;
+}
+
+// Records the deltas of SetTileTypes(map, tileIndices, count, type); call it right before
+// applying the change. Undone batches are discarded. If 'merge' is set and the newest batch
+// was also recorded with 'merge', the deltas are appended to it instead of starting a new step.
+void RecordTileTypes(UndoHistory* history, const Map* map, const int* tileIndices, int count, TileType type, bool merge) {
+    // A new edit invalidates everything that could be redone
+    if (history->batchApplied < history->batchCount) {
+        history->batchCount = history->batchApplied;
+        history->deltaHead = (history->batchCount > 0) ? undoBatchAt(history, history->batchCount - 1)->start + undoBatchAt(history, history->batchCount - 1)->count : history->deltaTail;
+    }
+
+    bool started = false;
+    for (int i = 0; i < count; i++) {
+        int index = tileIndices[i];
+        if (index < 0 || index >= map->tileCount || map->tiles[index].type == type) {
+            continue;
+        }
+
+        if (!started) {
+            started = true;
+            bool append = merge && history->batchCount > 0 && undoBatchAt(history, history->batchCount - 1)->mergeable;
+            if (!append) {
+                if (history->batchCount == UNDO_MAX_BATCHES) {
+                    dropOldestBatch(history);
+                }
+                UndoBatch* batch = undoBatchAt(history, history->batchCount);
+                batch->start = history->deltaHead;
+                batch->count = 0;
+                batch->mergeable = merge;
+                history->batchCount++;
+                history->batchApplied++;
+            }
+        }
+
+        TileDelta delta = { index, (unsigned char)map->tiles[index].type, (unsigned char)type };
+        if (!pushDelta(history, delta)) {
+            // The change is larger than the whole budget: it cannot be undone, and neither can
+            // anything before it
+            TraceLog(LOG_WARNING, "Terrain change exceeds the undo budget, history cleared");
+            history->batchCount = 0;
+            history->batchApplied = 0;
+            history->deltaTail = history->deltaHead;
+            return;
+        }
+    }
+}
+
+// Collects one entry per tile of a batch and applies them with a single map change.
+// Undo keeps the oldest 'old' type of every tile (forward scan), redo the newest 'new' type
+// (backward scan), so batches touching a tile several times revert correctly.
+static void applyBatch(UndoHistory* history, Map* map, const UndoBatch* batch, bool undo) {
+    int count = 0;
+    for (unsigned int n = 0; n < batch->count; n++) {
+        unsigned int position = undo ? batch->start + n : batch->start + batch->count - 1 - n;
+        const TileDelta* delta = undoDeltaAt(history, position);
+        uint32_t bit = 1u << (delta->tileIndex & 31);
+        if (history->seen[delta->tileIndex >> 5] & bit) {
+            continue;
+        }
+        history->seen[delta->tileIndex >> 5] |= bit;
+        history->revertIndices[count] = delta->tileIndex;
+        history->revertTypes[count] = (TileType)(undo ? delta->oldType : delta->newType);
+        count++;
+    }
+
+    for (int i = 0; i < count; i++) {
+        history->seen[history->revertIndices[i] >> 5] = 0;
+    }
+    SetTileTypeList(map, history->revertIndices, history->revertTypes, count);
+}
+
+bool UndoMapChange(UndoHistory* history, Map* map) {
+    if (!CanUndoMapChange(history)) {
+        return false;
+    }
+    history->batchApplied--;
+    applyBatch(history, map, undoBatchAt(history, history->batchApplied), true);
+    if (history->batchApplied > 0) {
+        undoBatchAt(history, history->batchApplied - 1)->mergeable = false;  // Edits after an undo start a new step
+    }
+    return true;
+}
+
+bool RedoMapChange(UndoHistory* history, Map* map) {
+    if (!CanRedoMapChange(history)) {
+        return false;
+    }
+    UndoBatch* batch = undoBatchAt(history, history->batchApplied);
+    applyBatch(history, map, batch, false);
+    batch->mergeable = false;
+    history->batchApplied++;
+    return true;
+}
@@ -0,0 +1,331 @@
+/*
+    This is a utility file for drawing one hex map through several viewports in raylib.
+
+    A Viewport is a rectangle of the screen with its own Camera2D (the camera offset is relative
+    to the viewport's top-left corner). All viewports draw the terrain from one shared
+    TerrainBake: the map is rendered once, with the shared tile atlas, into world-space chunk
+    render textures, and each viewport then only draws the few chunk quads it can see instead of
+    one sprite per tile. Chunks are baked the first time a viewport needs them, rebaked only
+    when a map change notification touches one of their tiles, and chunk textures that no
+    viewport has used recently are unloaded once more than TERRAIN_MAX_IDLE_CHUNKS are idle.
+
+    Every chunk keeps the list of tiles whose sprite overlaps it, in tile (draw) order, so a
+    chunk rebake draws exactly what the full map would have drawn there. Tiles can be baked
+    with a per-tile tint (e.g. fog of war); when tints change, InvalidateTerrainTiles() rebakes
+    only the chunks of the changed tiles.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - BeginViewport / EndViewport: Clip drawing to a viewport and apply its camera.
+    - GetViewportToWorld: Converts a screen position inside a viewport to world space.
+    - GetViewportWorldBounds: Returns the world-space rectangle a viewport can see.
+    - GetMapWorldBounds: Returns the world-space rectangle covered by the tile sprites of a map.
+    - InitTerrainBake: Prepares the chunk tile lists and registers for map changes.
+    - UnloadTerrainBake: Unloads the chunk textures and unregisters from the map.
+    - SetTerrainBakeTint: Sets (or removes) the per-tile tint the chunks are baked with.
+    - InvalidateTerrainTiles: Marks the chunks of some tiles for rebaking.
+    - UpdateTerrainBake: Bakes the dirty chunks visible in a set of world views.
+    - DrawTerrainBake: Draws the baked chunks overlapping a world view.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - Viewport: Screen rectangle plus camera.
+    - TerrainBake: World-space chunk render textures with per-chunk tile lists.
+*/
+
+#include <raylib.h>
+#include <raymath.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define TERRAIN_CHUNK_SIZE 512          // Chunk render texture size (world units = pixels)
+#define TERRAIN_MAX_IDLE_CHUNKS 64      // Chunk textures kept loaded while no viewport shows them
+
+typedef struct Viewport {
+    Rectangle bounds;   // Area of the screen (virtual coordinates) the viewport draws to
+    Camera2D camera;    // Camera; offset is relative to the top-left corner of bounds
+    bool visible;       // Is the viewport drawn (and does it receive input)?
+} Viewport;
+
+typedef struct TerrainBake {
+    Map* map;                   // Map the bake listens to
+    Layout layout;
+    Texture2D atlas;            // Shared tile atlas
+    Rectangle sources[TILE_TYPE_COUNT]; // Atlas rectangle per terrain type
+    Vector2 spriteSize;         // Size of a tile sprite, centered on the hex center
+    Color background;           // Chunk clear color (the viewports' background)
+    const Color* tint;          // Per-tile tint, NULL to bake every tile untinted
+
+    Rectangle worldBounds;      // Area covered by the chunk grid
+    int columns;
+    int rows;
+    RenderTexture2D* chunks;    // Chunk textures (id 0 while unloaded)
+    bool* dirty;                // Chunk needs to be (re)baked before it is drawn
+    unsigned int* lastUsed;     // Update number in which a viewport last showed the chunk
+    unsigned int updateCount;
+    int* chunkTileStart;        // Chunk c draws chunkTiles[chunkTileStart[c] .. chunkTileStart[c + 1])
+    int* chunkTiles;
+} TerrainBake;
+
+// Viewport functions
+
+void BeginViewport(const Viewport* viewport) {
+    Camera2D camera = viewport->camera;
+    camera.offset.x += viewport->bounds.x;
+    camera.offset.y += viewport->bounds.y;
+    BeginScissorMode((int)viewport->bounds.x, (int)viewport->bounds.y, (int)viewport->bounds.width, (int)viewport->bounds.height);
+    BeginMode2D(camera);
+}
+
+void EndViewport(void) {
+    EndMode2D();
+    EndScissorMode();
+}
+
+Vector2 GetViewportToWorld(const Viewport* viewport, Vector2 position) {
+    Vector2 local = { position.x - viewport->bounds.x, position.y - viewport->bounds.y };
+    return GetScreenToWorld2D(local, viewport->camera);
+}
+
+Rectangle GetViewportWorldBounds(const Viewport* viewport) {
+    Rectangle b = viewport->bounds;
+    Vector2 corners[4] = {
+        GetViewportToWorld(viewport, (Vector2){ b.x, b.y }),
+        GetViewportToWorld(viewport, (Vector2){ b.x + b.width, b.y }),
+        GetViewportToWorld(viewport, (Vector2){ b.x, b.y + b.height }),
+        GetViewportToWorld(viewport, (Vector2){ b.x + b.width, b.y + b.height })
+    };
+    Vector2 min = corners[0];
+    Vector2 max = corners[0];
+    for (int i = 1; i < 4; i++) {
+        min = Vector2Min(min, corners[i]);
+        max = Vector2Max(max, corners[i]);
+    }
+    return (Rectangle){ min.x, min.y, max.x - min.x, max.y - min.y };
+}
+
+static Rectangle tileSpriteRect(Layout layout, Hex hex, Vector2 spriteSize) {
+    Point center = HexToPixel(layout, hex);
+    return (Rectangle){ center.x - spriteSize.x / 2.0f, center.y - spriteSize.y / 2.0f, spriteSize.x, spriteSize.y };
+}
+
+Rectangle GetMapWorldBounds(const Map* map, Layout layout, Vector2 spriteSize) {
+    if (map->tileCount == 0) {
+        return (Rectangle){ 0 };
+    }
+    Rectangle first = tileSpriteRect(layout, map->tiles[0].position, spriteSize);
+    float minX = first.x, minY = first.y;
+    float maxX = first.x + first.width, maxY = first.y + first.height;
+    for (int i = 1; i < map->tileCount; i++) {
+        Rectangle r = tileSpriteRect(layout, map->tiles[i].position, spriteSize);
+        if (r.x < minX) minX = r.x;
+        if (r.y < minY) minY = r.y;
+        if (r.x + r.width > maxX) maxX = r.x + r.width;
+        if (r.y + r.height > maxY) maxY = r.y + r.height;
+    }
+    return (Rectangle){ minX, minY, maxX - minX, maxY - minY };
+}
+
+// Terrain bake functions
+
+// Chunk columns/rows overlapped by a world rectangle, clamped to the grid; false if none
+static bool chunkRange(const TerrainBake* bake, Rectangle rect, int* c0, int* r0, int* c1, int* r1) {
+    *c0 = (int)floorf((rect.x - bake->worldBounds.x) / TERRAIN_CHUNK_SIZE);
+    *r0 = (int)floorf((rect.y - bake->worldBounds.y) / TERRAIN_CHUNK_SIZE);
+    *c1 = (int)floorf((rect.x + rect.width - bake->worldBounds.x) / TERRAIN_CHUNK_SIZE);
+    *r1 = (int)floorf((rect.y + rect.height - bake->worldBounds.y) / TERRAIN_CHUNK_SIZE);
+    if (*c0 < 0) *c0 = 0;
+    if (*r0 < 0) *r0 = 0;
+    if (*c1 >= bake->columns) *c1 = bake->columns - 1;
+    if (*r1 >= bake->rows) *r1 = bake->rows - 1;
+    return (*c0 <= *c1 && *r0 <= *r1);
+}
+
+// Marks the chunks the sprites of some tiles overlap for rebaking
+void InvalidateTerrainTiles(TerrainBake* bake, const int* tileIndices, int count) {
+    if (bake->chunks == NULL) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        Rectangle rect = tileSpriteRect(bake->layout, bake->map->tiles[tileIndices[i]].position, bake->spriteSize);
+        int c0, r0, c1, r1;
+        if (!chunkRange(bake, rect, &c0, &r0, &c1, &r1)) continue;
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                bake->dirty[r * bake->columns + c] = true;
+            }
+        }
+    }
+}
+
+static void onTerrainChanged(const Map* map, MapChangeKind kind, const int* tileIndices, int count, void* userData) {
+    (void)map;
+    if (kind != MAP_CHANGE_TERRAIN) {
+        return;     // Overlay edges are not part of the bake
+    }
+    InvalidateTerrainTiles((TerrainBake*)userData, tileIndices, count);
+}
+
+// Bakes tile i tinted with tint[i] (the array must stay valid while it is set), or untinted
+// with NULL. Every chunk is rebaked; later tint changes only need InvalidateTerrainTiles().
+void SetTerrainBakeTint(TerrainBake* bake, const Color* tint) {
+    bake->tint = tint;
+    for (int c = 0; c < bake->columns * bake->rows; c++) bake->dirty[c] = true;
+}
+
+// Builds the chunk tile lists (CPU only); chunk textures are created by UpdateTerrainBake()
+void InitTerrainBake(TerrainBake* bake, Map* map, Layout layout, Texture2D atlas, const Rectangle* sources, Vector2 spriteSize, Color background) {
+    *bake = (TerrainBake){ 0 };
+    bake->map = map;
+    bake->layout = layout;
+    bake->atlas = atlas;
+    for (int t = 0; t < TILE_TYPE_COUNT; t++) bake->sources[t] = sources[t];
+    bake->spriteSize = spriteSize;
+    bake->background = background;
+
+    bake->worldBounds = GetMapWorldBounds(map, layout, spriteSize);
+    bake->columns = (int)ceilf(bake->worldBounds.width / TERRAIN_CHUNK_SIZE);
+    bake->rows = (int)ceilf(bake->worldBounds.height / TERRAIN_CHUNK_SIZE);
+    if (bake->columns < 1) bake->columns = 1;
+    if (bake->rows < 1) bake->rows = 1;
+    int chunkCount = bake->columns * bake->rows;
+
+    bake->chunks = (RenderTexture2D*)calloc(chunkCount, sizeof(RenderTexture2D));
+    bake->dirty = (bool*)malloc(chunkCount * sizeof(bool));
+    bake->lastUsed = (unsigned int*)calloc(chunkCount, sizeof(unsigned int));
+    bake->chunkTileStart = (int*)calloc(chunkCount + 1, sizeof(int));
+    for (int c = 0; c < chunkCount; c++) bake->dirty[c] = true;
+
+    // Two passes (count, then fill) keep every chunk list in tile order
+    for (int pass = 0; pass < 2; pass++) {
+        int* cursor = NULL;
+        if (pass == 1) {
+            for (int c = 0; c < chunkCount; c++) bake->chunkTileStart[c + 1] += bake->chunkTileStart[c];
+            bake->chunkTiles = (int*)malloc((bake->chunkTileStart[chunkCount] > 0 ? bake->chunkTileStart[chunkCount] : 1) * sizeof(int));
+            cursor = (int*)malloc(chunkCount * sizeof(int));
+            for (int c = 0; c < chunkCount; c++) cursor[c] = bake->chunkTileStart[c];
+        }
+
+        for (int i = 0; i < map->tileCount; i++) {
+            Rectangle rect = tileSpriteRect(layout, map->tiles[i].position, spriteSize);
+            int c0, r0, c1, r1;
+            if (!chunkRange(bake, rect, &c0, &r0, &c1, &r1)) continue;
+            for (int r = r0; r <= r1; r++) {
+                for (int c = c0; c <= c1; c++) {
+                    int chunk = r * bake->columns + c;
+                    if (pass == 0) bake->chunkTileStart[chunk + 1]++;
+                    else bake->chunkTiles[cursor[chunk]++] = i;
+                }
+            }
+        }
+        free(cursor);
+    }
+
+    AddMapChangeListener(map, onTerrainChanged, bake);
+}
+
+void UnloadTerrainBake(TerrainBake* bake) {
+    if (bake->chunks == NULL) {
+        return;
+    }
+    RemoveMapChangeListener(bake->map, onTerrainChanged, bake);
+    for (int c = 0; c < bake->columns * bake->rows; c++) {
+        if (bake->chunks[c].id != 0) UnloadRenderTexture(bake->chunks[c]);
+    }
+    free(bake->chunks);
+    free(bake->dirty);
+    free(bake->lastUsed);
+    free(bake->chunkTileStart);
+    free(bake->chunkTiles);
+    *bake = (TerrainBake){ 0 };
+}
+
+static void bakeChunk(TerrainBake* bake, int chunk) {
+    Camera2D camera = { 0 };
+    camera.target.x = bake->worldBounds.x + (chunk % bake->columns) * TERRAIN_CHUNK_SIZE;
+    camera.target.y = bake->worldBounds.y + (chunk / bake->columns) * TERRAIN_CHUNK_SIZE;
+    camera.zoom = 1.0f;
+
+    BeginTextureMode(bake->chunks[chunk]);
+    ClearBackground(bake->background);
+    BeginMode2D(camera);
+    for (int k = bake->chunkTileStart[chunk]; k < bake->chunkTileStart[chunk + 1]; k++) {
+        int index = bake->chunkTiles[k];
+        const Tile* tile = &bake->map->tiles[index];
+        Rectangle dest = tileSpriteRect(bake->layout, tile->position, bake->spriteSize);
+        DrawTexturePro(bake->atlas, bake->sources[tile->type], dest, (Vector2){ 0, 0 }, 0.0f, (bake->tint != NULL) ? bake->tint[index] : WHITE);
+    }
+    EndMode2D();
+    EndTextureMode();
+    bake->dirty[chunk] = false;
+}
+
+// Bakes every dirty chunk visible in one of the world views and unloads chunks that have
+// been idle the longest. Must be called outside BeginTextureMode()/EndTextureMode().
+// Returns the number of chunks baked.
+int UpdateTerrainBake(TerrainBake* bake, const Rectangle* worldViews, int viewCount) {
+    if (bake->chunks == NULL) {
+        return 0;
+    }
+    bake->updateCount++;
+
+    int baked = 0;
+    int usedCount = 0;
+    int residentCount = 0;
+    for (int v = 0; v < viewCount; v++) {
+        int c0, r0, c1, r1;
+        if (!chunkRange(bake, worldViews[v], &c0, &r0, &c1, &r1)) continue;
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                int chunk = r * bake->columns + c;
+                if (bake->lastUsed[chunk] != bake->updateCount) usedCount++;
+                bake->lastUsed[chunk] = bake->updateCount;
+                if (bake->chunks[chunk].id == 0) {
+                    bake->chunks[chunk] = LoadRenderTexture(TERRAIN_CHUNK_SIZE, TERRAIN_CHUNK_SIZE);
+                    bake->dirty[chunk] = true;
+                }
+                if (bake->dirty[chunk]) {
+                    bakeChunk(bake, chunk);
+                    baked++;
+                }
+            }
+        }
+    }
+
+    // Least recently used idle chunks go first
+    int chunkCount = bake->columns * bake->rows;
+    for (int c = 0; c < chunkCount; c++) {
+        if (bake->chunks[c].id != 0) residentCount++;
+    }
+    while (residentCount - usedCount > TERRAIN_MAX_IDLE_CHUNKS) {
+        int oldest = -1;
+        for (int c = 0; c < chunkCount; c++) {
+            if (bake->chunks[c].id != 0 && bake->lastUsed[c] != bake->updateCount &&
+                (oldest < 0 || bake->lastUsed[c] < bake->lastUsed[oldest])) oldest = c;
+        }
+        UnloadRenderTexture(bake->chunks[oldest]);
+        bake->chunks[oldest] = (RenderTexture2D){ 0 };
+        residentCount--;
+    }
+
+    return baked;
+}
+
+// Draws the baked chunks overlapping a world view (inside BeginViewport()/BeginMode2D())
+void DrawTerrainBake(const TerrainBake* bake, Rectangle worldView) {
+    int c0, r0, c1, r1;
+    if (bake->chunks == NULL || !chunkRange(bake, worldView, &c0, &r0, &c1, &r1)) {
+        return;
+    }
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            const RenderTexture2D* chunk = &bake->chunks[r * bake->columns + c];
+            if (chunk->id == 0) continue;
+            // Render textures are stored upside down
+            Rectangle source = { 0.0f, 0.0f, (float)TERRAIN_CHUNK_SIZE, -(float)TERRAIN_CHUNK_SIZE };
+            Rectangle dest = { bake->worldBounds.x + c * TERRAIN_CHUNK_SIZE, bake->worldBounds.y + r * TERRAIN_CHUNK_SIZE,
+                               (float)TERRAIN_CHUNK_SIZE, (float)TERRAIN_CHUNK_SIZE };
+            DrawTexturePro(chunk->texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+        }
+    }
+}
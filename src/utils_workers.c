@@ -0,0 +1,183 @@
+/*
+    This is a utility file for running data-parallel jobs on a small pool of worker threads.
+
+    A job is a function applied to the items [0, itemCount) of some caller-owned data. The
+    items are handed out in chunks from a shared counter, so fast workers take more chunks
+    and uneven items (e.g. long and short path queries) still balance. The calling thread
+    works as worker 0 and RunWorkerJob() returns once every item is done, so from the
+    caller's point of view a job is an ordinary blocking function call.
+
+    Every call of the job function gets the index of the worker running it, which lets jobs
+    keep per-worker scratch state (worker indices are 0 to GetWorkerCount() - 1). Which
+    worker processes which chunk is not deterministic; jobs that must give the same result
+    for any thread count should make each item's output depend only on that item.
+
+    Functions provided in this file include:
+    ------------------------------------------------------------------------
+    - InitWorkerPool: Starts the worker threads.
+    - UnloadWorkerPool: Stops and joins the worker threads.
+    - RunWorkerJob: Runs a job over a range of items and waits for it to finish.
+    - GetWorkerCount: Returns the number of workers, the calling thread included.
+    - GetProcessorCount: Returns the number of online processors.
+
+    Data Structures and definitions provided in this file:
+    ------------------------------------------------------------------------
+    - WorkerJob: Function processing a range of items on one worker.
+    - WorkerPool: Threads and the state of the job being run.
+*/
+
+#include <raylib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define MAX_WORKERS 16      // Workers per pool, the calling thread included
+
+// Processes items [first, last) on the given worker
+typedef void (*WorkerJob)(void* userData, int worker, int first, int last);
+
+struct WorkerPool;
+
+typedef struct WorkerThread {
+    struct WorkerPool* pool;
+    int index;
+} WorkerThread;
+
+typedef struct WorkerPool {
+    int workerCount;
+    pthread_t threads[MAX_WORKERS];
+    WorkerThread threadArgs[MAX_WORKERS];
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        // Signalled when a job starts or the pool shuts down
+    pthread_cond_t finished;    // Signalled when the last helper thread leaves a job
+
+    // Current job, protected by lock
+    WorkerJob job;
+    void* userData;
+    int itemCount;
+    int chunkSize;
+    int nextItem;               // First item not handed out yet
+    int busy;                   // Helper threads still inside the current job
+    unsigned int generation;    // Incremented per job
+    bool quit;
+} WorkerPool;
+
+int GetProcessorCount(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+}
+
+int GetWorkerCount(const WorkerPool* pool) {
+    return pool->workerCount;
+}
+
+// Takes chunks of the current job until none are left
+static void runWorkerChunks(WorkerPool* pool, int worker) {
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        int first = pool->nextItem;
+        pool->nextItem += pool->chunkSize;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (first >= pool->itemCount) {
+            return;
+        }
+        int last = (first + pool->chunkSize < pool->itemCount) ? first + pool->chunkSize : pool->itemCount;
+        pool->job(pool->userData, worker, first, last);
+    }
+}
+
+static void* workerThreadMain(void* arg) {
+    WorkerThread* thread = (WorkerThread*)arg;
+    WorkerPool* pool = thread->pool;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->quit && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->quit) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        runWorkerChunks(pool, thread->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->finished);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Starts workerCount - 1 threads (the caller is worker 0); workerCount is clamped to
+// [1, MAX_WORKERS]. The pool must stay at the same address until UnloadWorkerPool().
+void InitWorkerPool(WorkerPool* pool, int workerCount) {
+    *pool = (WorkerPool){ 0 };
+    if (workerCount < 1) workerCount = 1;
+    if (workerCount > MAX_WORKERS) workerCount = MAX_WORKERS;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+
+    pool->workerCount = 1;
+    for (int w = 1; w < workerCount; w++) {
+        pool->threadArgs[w].pool = pool;
+        pool->threadArgs[w].index = w;
+        if (pthread_create(&pool->threads[w], NULL, workerThreadMain, &pool->threadArgs[w]) != 0) {
+            TraceLog(LOG_WARNING, "Failed to start worker thread %d, using %d workers", w, pool->workerCount);
+            break;
+        }
+        pool->workerCount++;
+    }
+}
+
+void UnloadWorkerPool(WorkerPool* pool) {
+    if (pool->workerCount == 0) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int w = 1; w < pool->workerCount; w++) {
+        pthread_join(pool->threads[w], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->finished);
+    pool->workerCount = 0;
+}
+
+// Runs job over items [0, itemCount) in chunks of chunkSize items and returns when all of
+// them are done. Jobs must not call RunWorkerJob() on the same pool.
+void RunWorkerJob(WorkerPool* pool, WorkerJob job, void* userData, int itemCount, int chunkSize) {
+    if (itemCount <= 0) {
+        return;
+    }
+    if (chunkSize < 1) chunkSize = 1;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->userData = userData;
+    pool->itemCount = itemCount;
+    pool->chunkSize = chunkSize;
+    pool->nextItem = 0;
+    pool->busy = pool->workerCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    runWorkerChunks(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}